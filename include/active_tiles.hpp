@@ -0,0 +1,45 @@
+#ifndef ATPT_ACTIVE_TILES_HPP
+#define ATPT_ACTIVE_TILES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atpt{
+
+    // 64x64 セル (ビットグリッドの 1ワード x 64行) のタイルごとに「前の世代から変化したか」を持つ.
+    // 自分も 8近傍のタイルも変化していないタイルは次の世代も変わらないので, ステップを飛ばせる.
+    // 何世代かまとめて進めるときは, 変化が届きうる reach タイル先までを見る.
+    // タイルの並びはグリッドと同じく周期境界
+    class ActiveTiles{
+
+        //+   Member Variable    +//
+        int                  _tiles_x;
+        int                  _tiles_y;
+        std::vector<uint8_t> _changed;
+
+        public:
+        //+   Static Variable    +//
+        static constexpr int tile_log  = 6;
+        static constexpr int tile_size = 1 << tile_log;
+
+        //+   Member Function    +//
+        //_ Constructor
+        ActiveTiles (int, int);
+
+        //_ Constant Getter
+        auto changed (int tx_, int ty_)  const -> bool { return _changed[static_cast<size_t>(ty_) * _tiles_x + tx_]; }
+        auto active  (int, int, int = 1) const -> bool;
+        auto count   (void)              const -> size_t;
+
+        auto tilesX (void) const -> int { return _tiles_x; }
+        auto tilesY (void) const -> int { return _tiles_y; }
+
+        //_ Variable Function
+        auto set     (int tx_, int ty_, bool v_) -> void { _changed[static_cast<size_t>(ty_) * _tiles_x + tx_] = v_; }
+        auto markAll (void)                      -> void;
+        auto resize  (int, int)                  -> int;
+    };
+}
+
+#endif
@@ -2,19 +2,28 @@
 #define ATPT_BAD_NOISE_HPP
 
 #include <panel.hpp>
+#include <palette.hpp>
+#include <pixel_buffer.hpp>
+#include <texture.hpp>
+#include <triple_buffer.hpp>
 #include <random>
 #include <bgfx/bgfx.h>
 
 namespace atpt{
  
+    // 32bit LFSR の出力を 1ピクセル 1bit で並べる (周期が短いので模様が見える). 列は Lfsr32 で
+    // 64bit ずつ作り, 帯ごとに先頭のオフセットへ飛んでから並列に埋める. 結果は逐次に 1bit ずつ進めたものと同じ
     class BadNoise : public Panel{
         
         //+   Member Variable    +//
-        bgfx::UniformHandle   _uh;
-        bgfx::TextureHandle   _th;
-        std::vector<uint32_t> _pixels;
-        uint32_t              _seed;
-        uint32_t              _invar;
+        bgfx::UniformHandle      _sh;
+        Texture                  _texture;
+        StateBuffer              _states;
+        TripleBuffer<StateFrame> _frames;
+        Palette                  _palette;
+        uint64_t                 _generation;
+        uint32_t                 _seed;
+        uint32_t                 _invar;
 
         public:
         //+   Member Function    +//
@@ -25,11 +34,12 @@ namespace atpt{
         auto seed (void) -> uint32_t { return _seed; }
         
         //_ Variable Function
-        auto _resize  (int, int)         -> int override;
-        auto _draw    (void)             -> int override;
-        auto _event   (const SDL_Event&) -> int override;
-        auto _destroy (void)             -> int override;
-
+        auto _resize     (int, int)         -> int override;
+        auto _step       (bool, int)        -> int override;
+        auto _present    (void)             -> int override;
+        auto _event      (const SDL_Event&) -> int override;
+        auto _activate   (void)             -> int override;
+        auto _deactivate (void)             -> int override;
     };
 }
 
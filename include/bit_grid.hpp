@@ -0,0 +1,54 @@
+#ifndef ATPT_BIT_GRID_HPP
+#define ATPT_BIT_GRID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atpt{
+
+    // 1 cell = 1 bit. Row y holds _words uint64_t, cell x lives in bit (x & 63) of word (x >> 6).
+    // Rows carry one halo word on each side and the grid one halo row above and below, so
+    // row(y)[-1 .. words()] is valid for y in [-1, height()]. fillHalo() refreshes them:
+    //   row(y)[-1]    : bit 63 = cell (width - 1, y)
+    //   row(y)[words] : bit 0  = cell (0, y)              (when width % 64 == 0)
+    //   row(y)[last]  : bit (width % 64) = cell (0, y)    (otherwise, the first unused bit)
+    // so that (w << 1 | prev >> 63) and (w >> 1 | next << 63) give the periodic x-1 / x+1 cells.
+    class PeriodicBoundaryBitGrid{
+
+        //+   Member Variable    +//
+        int                   _width;
+        int                   _height;
+        int                   _words;
+        std::vector<uint64_t> _vector;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        PeriodicBoundaryBitGrid (int, int);
+
+        public:
+        //_ Constant Getter
+        auto operator () (int x_, int y_) const -> bool { return (row(y_)[x_ >> 6] >> (x_ & 63)) & 1u; }
+        auto row         (int y_)         const -> const uint64_t* { return _vector.data() + static_cast<size_t>(y_ + 1) * stride() + 1; }
+        auto tailMask    (void)           const -> uint64_t;
+
+        auto width  (void) const -> int                          { return _width; }
+        auto height (void) const -> int                          { return _height; }
+        auto words  (void) const -> int                          { return _words; }
+        auto stride (void) const -> int                          { return _words + 2; }
+        auto vector (void) const -> const std::vector<uint64_t>& { return _vector; }
+
+        public:
+        //_ Getter
+        auto row (int y_) -> uint64_t* { return _vector.data() + static_cast<size_t>(y_ + 1) * stride() + 1; }
+
+        public:
+        //_ Variable Function
+        auto set      (int, int, bool) -> void;
+        auto resize   (int, int)       -> int;
+        auto fillHalo (void)           -> void;
+    };
+}
+
+#endif
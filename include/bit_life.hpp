@@ -0,0 +1,44 @@
+#ifndef ATPT_BIT_LIFE_HPP
+#define ATPT_BIT_LIFE_HPP
+
+#include <bit_grid.hpp>
+#include <active_tiles.hpp>
+#include <cpu_features.hpp>
+#include <life_like_rule.hpp>
+
+namespace atpt{
+
+    // Rule の1世代を src_ から dst_ へ 64セル/ワード単位で計算する (src_ のハローは埋まっていること).
+    // 規則はコンパイル時に論理式へ展開されるので, 規則ごとに専用のカーネルが生成される
+    template <typename Rule = Conway>
+    auto bitLifeStep (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_) -> int;
+
+    // 行 [y0_, y1_) だけを計算する. 帯ごとに並列に呼んだ後, 呼び出し側で dst_.fillHalo() すること
+    template <typename Rule = Conway>
+    auto bitLifeStepRows (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, int y0_, int y1_) -> void;
+
+    // in_ で自分か近傍が変化したタイルだけを計算し, 各タイルが変化したかを out_ に書く. タイル行 [ty0_, ty1_) を担当する.
+    // dst_ には 2世代前 (in_ を作ったステップの入力) が入っていること. 計算しないタイルはそれが src_ と同じなので書かない
+    template <typename Rule = Conway>
+    auto bitLifeStepTiles (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_) -> void;
+
+    // 上と同じだが, 前の世代から変わったワードごとに計算した直後 (キャッシュにあるうち) に sink_(y, i, word) を呼ぶ.
+    // 画素やパレット番号への書き出しをステップと同じパスで済ませるのに使う. 最後のワードは tailMask() で切ってある
+    template <typename Rule = Conway, typename Sink>
+    auto bitLifeStepTiles (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_, Sink&& sink_) -> void;
+
+    // in_ から generations_ 世代 (1 〜 ActiveTiles::tile_size) をまとめて進め, 最後の世代を dst_ に書く. タイル行 [ty0_, ty1_) を担当する.
+    // タイルごとに上下 generations_ 行と左右 1ワードを足した窓を作業領域に読み, 窓を 1世代ごとに削りながらキャッシュの中だけで進める
+    // (台形の時間ブロッキング). src_ / dst_ は 1回ずつしかなめないので, 大きなグリッドでもメモリの往復は 1世代分で済む.
+    // out_ にはタイルが最初と最後, または最後の 2世代で違っていたかを書く. 前提は bitLifeStepTiles と同じで,
+    // このあと 1世代ずつのステップに戻っても, そのまま続けられる
+    template <typename Rule = Conway>
+    auto bitLifeStepBlocked (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_, int generations_) -> void;
+
+    // 行カーネルは起動時に detectSimdLevel() で選ばれる. 比較用に下位の命令セット (Scalar まで) へ落とせる
+    auto setBitLifeSimdLevel (SimdLevel) -> void;
+    auto bitLifeSimdLevel    (void)      -> SimdLevel;
+}
+
+#include "bit_life.inl"
+#endif
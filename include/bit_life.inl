@@ -0,0 +1,551 @@
+#ifndef ATPT_BIT_LIFE_INL
+#define ATPT_BIT_LIFE_INL
+
+#include "bit_life.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if ATPT_X86
+    #include <immintrin.h>
+#endif
+
+namespace atpt{
+
+    namespace _bit_life{
+
+        using RowKernel = void (*)(const uint64_t*, const uint64_t*, const uint64_t*, uint64_t*, int, int);
+
+        // 規則を (中心 c, 近傍の和のビット s0, s1, s2, s3) の真理値表にする. index = c + 2 * sum.
+        // sum = 8 のとき (s3 = 1) は s0..s2 が 0 なので, 上半分は sum = 8 の値で埋めておく
+        template <typename Rule>
+        constexpr auto slicedTable (void)
+            -> uint32_t
+        {
+            uint32_t t = 0;
+            for(int i = 0; i < 32; ++i){
+                const int sum = (i >> 1) < 8 ? (i >> 1) : 8;
+                if (Rule::next(i & 1, sum)) t |= 1u << i;
+            }
+            return t;
+        }
+
+
+        // 8 と 0 で結果が同じなら 3 ビットの和 (8 は 0 に折り返す) で足りるので s3 は見ない
+        template <typename Rule>
+        constexpr bool needs_s3 = Rule::next(false, 0) != Rule::next(false, 8) or Rule::next(true, 0) != Rule::next(true, 8);
+
+        template <typename Rule>
+        constexpr int table_level = needs_s3<Rule> ? 5 : 4;
+
+
+        // 真理値表を最上位の変数で分けて (Shannon 展開) 論理式を組み立てる. 定数や片側が定数の枝はここで畳む
+        enum class Node{ Zero, Ones, Same, Var, And, AndNot, Or, Mux };
+
+        constexpr auto full (int level_) -> uint32_t { return static_cast<uint32_t>((uint64_t{1} << (1 << level_)) - 1); }
+        constexpr auto lo   (uint32_t table_, int level_) -> uint32_t { return table_ & full(level_ - 1); }
+        constexpr auto hi   (uint32_t table_, int level_) -> uint32_t { return (table_ >> (1 << (level_ - 1))) & full(level_ - 1); }
+
+        constexpr auto nodeOf (uint32_t table_, int level_)
+            -> Node
+        {
+            table_ &= full(level_);
+            if (table_ == 0)            return Node::Zero;
+            if (table_ == full(level_)) return Node::Ones;
+
+            const uint32_t l = lo(table_, level_);
+            const uint32_t h = hi(table_, level_);
+            const uint32_t f = full(level_ - 1);
+            if (l == h)            return Node::Same;
+            if (l == 0 and h == f) return Node::Var;
+            if (l == 0)            return Node::And;
+            if (h == 0)            return Node::AndNot;
+            if (h == f)            return Node::Or;
+            return Node::Mux;
+        }
+
+
+        // a + b + c -> (sum, carry)
+        ATPT_INLINE void fullAdd (uint64_t a_, uint64_t b_, uint64_t c_, uint64_t& s_, uint64_t& k_)
+        {
+            const uint64_t t = a_ ^ b_;
+            s_ = t ^ c_;
+            k_ = (a_ & b_) | (t & c_);
+        }
+
+
+        // v_ = { c, s0, s1, s2, s3 }. Level_ 個の下位変数だけに依存する
+        template <uint32_t Table_, int Level_>
+        ATPT_INLINE auto synthScalar (const uint64_t (&v_)[5])
+            -> uint64_t
+        {
+            constexpr Node node = nodeOf(Table_, Level_);
+            if      constexpr (node == Node::Zero) return 0;
+            else if constexpr (node == Node::Ones) return ~uint64_t{0};
+            else{
+                constexpr uint32_t l = lo(Table_, Level_);
+                constexpr uint32_t h = hi(Table_, Level_);
+                const     uint64_t x = v_[Level_ - 1];
+                if      constexpr (node == Node::Same)   return synthScalar<l, Level_ - 1>(v_);
+                else if constexpr (node == Node::Var)    return x;
+                else if constexpr (node == Node::And)    return x & synthScalar<h, Level_ - 1>(v_);
+                else if constexpr (node == Node::AndNot) return ~x & synthScalar<l, Level_ - 1>(v_);
+                else if constexpr (node == Node::Or)     return x | synthScalar<l, Level_ - 1>(v_);
+                else{
+                    const uint64_t a = synthScalar<l, Level_ - 1>(v_);
+                    const uint64_t b = synthScalar<h, Level_ - 1>(v_);
+                    return a ^ (x & (a ^ b));
+                }
+            }
+        }
+
+
+        // 1ワード分. ハローがあるので i_ - 1, i_ + 1 は常に読める
+        template <typename Rule>
+        ATPT_INLINE auto stepWord (const uint64_t* n_, const uint64_t* c_, const uint64_t* s_, int i_)
+            -> uint64_t
+        {
+            const uint64_t nw = (n_[i_] << 1) | (n_[i_ - 1] >> 63);
+            const uint64_t ne = (n_[i_] >> 1) | (n_[i_ + 1] << 63);
+            const uint64_t cw = (c_[i_] << 1) | (c_[i_ - 1] >> 63);
+            const uint64_t ce = (c_[i_] >> 1) | (c_[i_ + 1] << 63);
+            const uint64_t sw = (s_[i_] << 1) | (s_[i_ - 1] >> 63);
+            const uint64_t se = (s_[i_] >> 1) | (s_[i_ + 1] << 63);
+
+            // 8近傍の和をビットスライスで数える
+            uint64_t a1, a2, c1, c2, s0, k1, t, k2;
+            fullAdd(nw, n_[i_], ne, a1, a2);
+            fullAdd(sw, s_[i_], se, c1, c2);
+            const uint64_t b1 = cw ^ ce;
+            const uint64_t b2 = cw & ce;
+
+            fullAdd(a1, b1, c1, s0, k1);
+            fullAdd(a2, b2, c2, t,  k2);
+
+            const uint64_t v[5] = { c_[i_], s0, t ^ k1, k2 ^ (t & k1), k2 & t & k1 };
+            return synthScalar<slicedTable<Rule>(), table_level<Rule>>(v);
+        }
+
+
+        template <typename Rule>
+        void stepRowScalar (const uint64_t* n_, const uint64_t* c_, const uint64_t* s_, uint64_t* out_, int begin_, int end_)
+        {
+            for(int i = begin_; i < end_; ++i) out_[i] = stepWord<Rule>(n_, c_, s_, i);
+        }
+
+
+#if ATPT_X86
+        template <uint32_t Table_, int Level_>
+        ATPT_TARGET("sse2") ATPT_INLINE auto synthSSE2 (const __m128i (&v_)[5])
+            -> __m128i
+        {
+            constexpr Node node = nodeOf(Table_, Level_);
+            if      constexpr (node == Node::Zero) return _mm_setzero_si128();
+            else if constexpr (node == Node::Ones) return _mm_set1_epi32(-1);
+            else{
+                constexpr uint32_t l = lo(Table_, Level_);
+                constexpr uint32_t h = hi(Table_, Level_);
+                const     __m128i  x = v_[Level_ - 1];
+                if      constexpr (node == Node::Same)   return synthSSE2<l, Level_ - 1>(v_);
+                else if constexpr (node == Node::Var)    return x;
+                else if constexpr (node == Node::And)    return _mm_and_si128(x, synthSSE2<h, Level_ - 1>(v_));
+                else if constexpr (node == Node::AndNot) return _mm_andnot_si128(x, synthSSE2<l, Level_ - 1>(v_));
+                else if constexpr (node == Node::Or)     return _mm_or_si128(x, synthSSE2<l, Level_ - 1>(v_));
+                else{
+                    const __m128i a = synthSSE2<l, Level_ - 1>(v_);
+                    const __m128i b = synthSSE2<h, Level_ - 1>(v_);
+                    return _mm_xor_si128(a, _mm_and_si128(x, _mm_xor_si128(a, b)));
+                }
+            }
+        }
+
+
+        template <typename Rule>
+        ATPT_TARGET("sse2")
+        void stepRowSSE2 (const uint64_t* n_, const uint64_t* c_, const uint64_t* s_, uint64_t* out_, int begin_, int end_)
+        {
+            int i = begin_;
+            for(; i + 2 <= end_; i += 2){
+                const __m128i n  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(n_ + i));
+                const __m128i c  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c_ + i));
+                const __m128i s  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s_ + i));
+                const __m128i nw = _mm_or_si128(_mm_slli_epi64(n, 1), _mm_srli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(n_ + i - 1)), 63));
+                const __m128i ne = _mm_or_si128(_mm_srli_epi64(n, 1), _mm_slli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(n_ + i + 1)), 63));
+                const __m128i cw = _mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c_ + i - 1)), 63));
+                const __m128i ce = _mm_or_si128(_mm_srli_epi64(c, 1), _mm_slli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c_ + i + 1)), 63));
+                const __m128i sw = _mm_or_si128(_mm_slli_epi64(s, 1), _mm_srli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s_ + i - 1)), 63));
+                const __m128i se = _mm_or_si128(_mm_srli_epi64(s, 1), _mm_slli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s_ + i + 1)), 63));
+
+                const __m128i ta = _mm_xor_si128(nw, n);
+                const __m128i a1 = _mm_xor_si128(ta, ne);
+                const __m128i a2 = _mm_or_si128(_mm_and_si128(nw, n), _mm_and_si128(ta, ne));
+                const __m128i tc = _mm_xor_si128(sw, s);
+                const __m128i c1 = _mm_xor_si128(tc, se);
+                const __m128i c2 = _mm_or_si128(_mm_and_si128(sw, s), _mm_and_si128(tc, se));
+                const __m128i b1 = _mm_xor_si128(cw, ce);
+                const __m128i b2 = _mm_and_si128(cw, ce);
+
+                const __m128i t1 = _mm_xor_si128(a1, b1);
+                const __m128i s0 = _mm_xor_si128(t1, c1);
+                const __m128i k1 = _mm_or_si128(_mm_and_si128(a1, b1), _mm_and_si128(t1, c1));
+                const __m128i t2 = _mm_xor_si128(a2, b2);
+                const __m128i t  = _mm_xor_si128(t2, c2);
+                const __m128i k2 = _mm_or_si128(_mm_and_si128(a2, b2), _mm_and_si128(t2, c2));
+                const __m128i tk = _mm_and_si128(t, k1);
+
+                const __m128i v[5] = { c, s0, _mm_xor_si128(t, k1), _mm_xor_si128(k2, tk), _mm_and_si128(k2, tk) };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out_ + i), synthSSE2<slicedTable<Rule>(), table_level<Rule>>(v));
+            }
+            stepRowScalar<Rule>(n_, c_, s_, out_, i, end_);
+        }
+
+
+        template <uint32_t Table_, int Level_>
+        ATPT_TARGET("avx2") ATPT_INLINE auto synthAVX2 (const __m256i (&v_)[5])
+            -> __m256i
+        {
+            constexpr Node node = nodeOf(Table_, Level_);
+            if      constexpr (node == Node::Zero) return _mm256_setzero_si256();
+            else if constexpr (node == Node::Ones) return _mm256_set1_epi32(-1);
+            else{
+                constexpr uint32_t l = lo(Table_, Level_);
+                constexpr uint32_t h = hi(Table_, Level_);
+                const     __m256i  x = v_[Level_ - 1];
+                if      constexpr (node == Node::Same)   return synthAVX2<l, Level_ - 1>(v_);
+                else if constexpr (node == Node::Var)    return x;
+                else if constexpr (node == Node::And)    return _mm256_and_si256(x, synthAVX2<h, Level_ - 1>(v_));
+                else if constexpr (node == Node::AndNot) return _mm256_andnot_si256(x, synthAVX2<l, Level_ - 1>(v_));
+                else if constexpr (node == Node::Or)     return _mm256_or_si256(x, synthAVX2<l, Level_ - 1>(v_));
+                else{
+                    const __m256i a = synthAVX2<l, Level_ - 1>(v_);
+                    const __m256i b = synthAVX2<h, Level_ - 1>(v_);
+                    return _mm256_xor_si256(a, _mm256_and_si256(x, _mm256_xor_si256(a, b)));
+                }
+            }
+        }
+
+
+        template <typename Rule>
+        ATPT_TARGET("avx2")
+        void stepRowAVX2 (const uint64_t* n_, const uint64_t* c_, const uint64_t* s_, uint64_t* out_, int begin_, int end_)
+        {
+            int i = begin_;
+            for(; i + 4 <= end_; i += 4){
+                const __m256i n  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(n_ + i));
+                const __m256i c  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c_ + i));
+                const __m256i s  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s_ + i));
+                const __m256i nw = _mm256_or_si256(_mm256_slli_epi64(n, 1), _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(n_ + i - 1)), 63));
+                const __m256i ne = _mm256_or_si256(_mm256_srli_epi64(n, 1), _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(n_ + i + 1)), 63));
+                const __m256i cw = _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c_ + i - 1)), 63));
+                const __m256i ce = _mm256_or_si256(_mm256_srli_epi64(c, 1), _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c_ + i + 1)), 63));
+                const __m256i sw = _mm256_or_si256(_mm256_slli_epi64(s, 1), _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s_ + i - 1)), 63));
+                const __m256i se = _mm256_or_si256(_mm256_srli_epi64(s, 1), _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s_ + i + 1)), 63));
+
+                const __m256i ta = _mm256_xor_si256(nw, n);
+                const __m256i a1 = _mm256_xor_si256(ta, ne);
+                const __m256i a2 = _mm256_or_si256(_mm256_and_si256(nw, n), _mm256_and_si256(ta, ne));
+                const __m256i tc = _mm256_xor_si256(sw, s);
+                const __m256i c1 = _mm256_xor_si256(tc, se);
+                const __m256i c2 = _mm256_or_si256(_mm256_and_si256(sw, s), _mm256_and_si256(tc, se));
+                const __m256i b1 = _mm256_xor_si256(cw, ce);
+                const __m256i b2 = _mm256_and_si256(cw, ce);
+
+                const __m256i t1 = _mm256_xor_si256(a1, b1);
+                const __m256i s0 = _mm256_xor_si256(t1, c1);
+                const __m256i k1 = _mm256_or_si256(_mm256_and_si256(a1, b1), _mm256_and_si256(t1, c1));
+                const __m256i t2 = _mm256_xor_si256(a2, b2);
+                const __m256i t  = _mm256_xor_si256(t2, c2);
+                const __m256i k2 = _mm256_or_si256(_mm256_and_si256(a2, b2), _mm256_and_si256(t2, c2));
+                const __m256i tk = _mm256_and_si256(t, k1);
+
+                const __m256i v[5] = { c, s0, _mm256_xor_si256(t, k1), _mm256_xor_si256(k2, tk), _mm256_and_si256(k2, tk) };
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_ + i), synthAVX2<slicedTable<Rule>(), table_level<Rule>>(v));
+            }
+            stepRowSSE2<Rule>(n_, c_, s_, out_, i, end_);
+        }
+
+
+        // 分岐は vpternlogq 1命令ずつ (0xCA: a ? b : c)
+        template <uint32_t Table_, int Level_>
+        ATPT_TARGET("avx512f") ATPT_INLINE auto synthAVX512 (const __m512i (&v_)[5])
+            -> __m512i
+        {
+            constexpr Node node = nodeOf(Table_, Level_);
+            if      constexpr (node == Node::Zero) return _mm512_setzero_si512();
+            else if constexpr (node == Node::Ones) return _mm512_set1_epi32(-1);
+            else{
+                constexpr uint32_t l = lo(Table_, Level_);
+                constexpr uint32_t h = hi(Table_, Level_);
+                const     __m512i  x = v_[Level_ - 1];
+                if      constexpr (node == Node::Same)   return synthAVX512<l, Level_ - 1>(v_);
+                else if constexpr (node == Node::Var)    return x;
+                else if constexpr (node == Node::And)    return _mm512_and_si512(x, synthAVX512<h, Level_ - 1>(v_));
+                else if constexpr (node == Node::AndNot) return _mm512_andnot_si512(x, synthAVX512<l, Level_ - 1>(v_));
+                else if constexpr (node == Node::Or)     return _mm512_or_si512(x, synthAVX512<l, Level_ - 1>(v_));
+                else{
+                    const __m512i a = synthAVX512<l, Level_ - 1>(v_);
+                    const __m512i b = synthAVX512<h, Level_ - 1>(v_);
+                    return _mm512_ternarylogic_epi64(x, b, a, 0xCA);
+                }
+            }
+        }
+
+
+        // 全加算器は vpternlogq 1命令ずつ (0x96: a^b^c, 0xE8: 多数決).
+        // GCC 12 は _mm512_slli_epi64 / _mm512_srli_epi64 の中の _mm512_undefined_epi32() を未初期化と誤って警告するので, ここだけ黙らせる
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+        template <typename Rule>
+        ATPT_TARGET("avx512f")
+        void stepRowAVX512 (const uint64_t* n_, const uint64_t* c_, const uint64_t* s_, uint64_t* out_, int begin_, int end_)
+        {
+            int i = begin_;
+            for(; i + 8 <= end_; i += 8){
+                const __m512i n  = _mm512_loadu_si512(n_ + i);
+                const __m512i c  = _mm512_loadu_si512(c_ + i);
+                const __m512i s  = _mm512_loadu_si512(s_ + i);
+                const __m512i nw = _mm512_or_si512(_mm512_slli_epi64(n, 1), _mm512_srli_epi64(_mm512_loadu_si512(n_ + i - 1), 63));
+                const __m512i ne = _mm512_or_si512(_mm512_srli_epi64(n, 1), _mm512_slli_epi64(_mm512_loadu_si512(n_ + i + 1), 63));
+                const __m512i cw = _mm512_or_si512(_mm512_slli_epi64(c, 1), _mm512_srli_epi64(_mm512_loadu_si512(c_ + i - 1), 63));
+                const __m512i ce = _mm512_or_si512(_mm512_srli_epi64(c, 1), _mm512_slli_epi64(_mm512_loadu_si512(c_ + i + 1), 63));
+                const __m512i sw = _mm512_or_si512(_mm512_slli_epi64(s, 1), _mm512_srli_epi64(_mm512_loadu_si512(s_ + i - 1), 63));
+                const __m512i se = _mm512_or_si512(_mm512_srli_epi64(s, 1), _mm512_slli_epi64(_mm512_loadu_si512(s_ + i + 1), 63));
+
+                const __m512i a1 = _mm512_ternarylogic_epi64(nw, n, ne, 0x96);
+                const __m512i a2 = _mm512_ternarylogic_epi64(nw, n, ne, 0xE8);
+                const __m512i c1 = _mm512_ternarylogic_epi64(sw, s, se, 0x96);
+                const __m512i c2 = _mm512_ternarylogic_epi64(sw, s, se, 0xE8);
+                const __m512i b1 = _mm512_xor_si512(cw, ce);
+                const __m512i b2 = _mm512_and_si512(cw, ce);
+
+                const __m512i s0 = _mm512_ternarylogic_epi64(a1, b1, c1, 0x96);
+                const __m512i k1 = _mm512_ternarylogic_epi64(a1, b1, c1, 0xE8);
+                const __m512i t  = _mm512_ternarylogic_epi64(a2, b2, c2, 0x96);
+                const __m512i k2 = _mm512_ternarylogic_epi64(a2, b2, c2, 0xE8);
+
+                // s2 = k2 ^ (t & k1) (0x78), s3 = k2 & t & k1 (0x80)
+                const __m512i v[5] = { c, s0, _mm512_xor_si512(t, k1), _mm512_ternarylogic_epi64(k2, t, k1, 0x78), _mm512_ternarylogic_epi64(k2, t, k1, 0x80) };
+                _mm512_storeu_si512(out_ + i, synthAVX512<slicedTable<Rule>(), table_level<Rule>>(v));
+            }
+            stepRowScalar<Rule>(n_, c_, s_, out_, i, end_);
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+#endif
+
+
+        // セル x_ (周期境界で折り返す) から 64セルを 1ワードに集める. 境界をまたがなければそのままワードを返す
+        inline auto gatherWord (const PeriodicBoundaryBitGrid& grid_, const uint64_t* row_, int x_)
+            -> uint64_t
+        {
+            const int width = grid_.width();
+            x_ = (x_ % width + width) % width;
+            if ((x_ & 63) == 0 and x_ + 64 <= width) return row_[x_ >> 6];
+
+            uint64_t w = 0;
+            for(int got = 0; got < 64; ){
+                const int      off  = x_ & 63;
+                const int      take = std::min({ 64 - off, width - x_, 64 - got });
+                const uint64_t mask = take == 64 ? ~uint64_t{0} : (uint64_t{1} << take) - 1;
+                w   |= ((row_[x_ >> 6] >> off) & mask) << got;
+                got += take;
+                x_  += take;
+                if (x_ == width) x_ = 0;
+            }
+            return w;
+        }
+
+
+        template <typename Rule>
+        auto kernelFor (SimdLevel level_)
+            -> RowKernel
+        {
+#if ATPT_X86
+            switch (level_) {
+                case SimdLevel::AVX512: return stepRowAVX512<Rule>;
+                case SimdLevel::AVX2:   return stepRowAVX2<Rule>;
+                case SimdLevel::SSE2:   return stepRowSSE2<Rule>;
+                default:                break;
+            }
+#endif
+            return stepRowScalar<Rule>;
+        }
+    }
+
+
+    template <typename Rule>
+    auto bitLifeStep (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_)
+        -> int
+    {
+        if (dst_.width() != src_.width() or dst_.height() != src_.height()) return 1;
+        if (src_.width() == 0 or src_.height() == 0)                        return 0;
+
+        bitLifeStepRows<Rule>(src_, dst_, 0, src_.height());
+        dst_.fillHalo();
+
+        return 0;
+    }
+
+
+    template <typename Rule>
+    auto bitLifeStepRows (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, int y0_, int y1_)
+        -> void
+    {
+        const int                  words  = src_.words();
+        const uint64_t             tail   = src_.tailMask();
+        const _bit_life::RowKernel kernel = _bit_life::kernelFor<Rule>(bitLifeSimdLevel());
+
+        // ハロー行・ハローワードがあるので境界でも分岐しない
+        for(int b = y0_; b < y1_; ++b){
+            uint64_t* out = dst_.row(b);
+            kernel(src_.row(b - 1), src_.row(b), src_.row(b + 1), out, 0, words);
+            out[words - 1] &= tail;
+        }
+    }
+
+
+    template <typename Rule>
+    auto bitLifeStepTiles (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_)
+        -> void
+    {
+        bitLifeStepTiles<Rule>(src_, dst_, in_, out_, ty0_, ty1_, [](int, int, uint64_t){});
+    }
+
+
+    template <typename Rule, typename Sink>
+    auto bitLifeStepTiles (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_, Sink&& sink_)
+        -> void
+    {
+        const int                  words  = src_.words();
+        const uint64_t             tail   = src_.tailMask();
+        const _bit_life::RowKernel kernel = _bit_life::kernelFor<Rule>(bitLifeSimdLevel());
+
+        // タイルの幅はちょうど 1ワードなので, タイル列 tx はワード tx に対応する
+        std::vector<uint8_t> active(static_cast<size_t>(in_.tilesX()));
+
+        for(int ty = ty0_; ty < ty1_; ++ty){
+            for(int tx = 0; tx < in_.tilesX(); ++tx){
+                active[tx] = in_.active(tx, ty);
+                out_.set(tx, ty, false);
+            }
+
+            const int y0 = ty << ActiveTiles::tile_log;
+            const int y1 = std::min(y0 + ActiveTiles::tile_size, src_.height());
+
+            // 連続した計算対象のワードはまとめてカーネルに渡す
+            for(int i0 = 0; i0 < words; ){
+                if (not active[i0]) { ++i0; continue; }
+                int i1 = i0 + 1;
+                while (i1 < words and active[i1]) ++i1;
+
+                for(int b = y0; b < y1; ++b){
+                    const uint64_t* cur = src_.row(b);
+                    uint64_t*       out = dst_.row(b);
+                    kernel(src_.row(b - 1), cur, src_.row(b + 1), out, i0, i1);
+                    if (i1 == words) out[words - 1] &= tail;
+
+                    // src_ の最後のワードにはハローのビットが入っているので比べる前に落とす
+                    for(int i = i0; i < i1; ++i){
+                        const uint64_t mask = (i == words - 1) ? tail : ~uint64_t{0};
+                        if ((out[i] ^ cur[i]) & mask) {
+                            out_.set(i, ty, true);
+                            sink_(b, i, out[i]);
+                        }
+                    }
+                }
+                i0 = i1;
+            }
+        }
+    }
+
+
+    template <typename Rule>
+    auto bitLifeStepBlocked (const PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, const ActiveTiles& in_, ActiveTiles& out_, int ty0_, int ty1_, int generations_)
+        -> void
+    {
+        constexpr int chunk = 64;    // 窓の中身の最大ワード数 (作業領域を L2 に収める)
+
+        const int                  words  = src_.words();
+        const int                  height = src_.height();
+        const int                  k      = std::clamp(generations_, 1, ActiveTiles::tile_size);
+        const uint64_t             tail   = src_.tailMask();
+        const _bit_life::RowKernel kernel = _bit_life::kernelFor<Rule>(bitLifeSimdLevel());
+
+        // 端のタイルが k セルより薄いと, 変化はそれを越えて 2タイル先まで届く
+        const int narrow = std::min(src_.width()  - ((in_.tilesX() - 1) << ActiveTiles::tile_log),
+                                    height        - ((in_.tilesY() - 1) << ActiveTiles::tile_log));
+        const int reach  = k > narrow ? 2 : 1;
+
+        // 窓は上下 k 行, 左右 2ワード (1ワードは計算し, 外側の 1ワードは読むだけ) 広い. 外側の古い値が作る誤差は
+        // 1世代に 1セルしか進まないので, k <= 64 世代では内側の 1ワードを越えない
+        const int stride = chunk + 4;
+        const int rows   = ActiveTiles::tile_size + 2 * k;
+        static thread_local std::vector<uint64_t> scratch;
+        scratch.resize(static_cast<size_t>(2 * rows) * stride);
+        uint64_t* const buf[2] = { scratch.data(), scratch.data() + static_cast<size_t>(rows) * stride };
+
+        std::vector<uint8_t> active(static_cast<size_t>(in_.tilesX()));
+
+        for(int ty = ty0_; ty < ty1_; ++ty){
+            for(int tx = 0; tx < in_.tilesX(); ++tx){
+                active[tx] = in_.active(tx, ty, reach);
+                out_.set(tx, ty, false);
+            }
+
+            const int y0 = ty << ActiveTiles::tile_log;
+            const int y1 = std::min(y0 + ActiveTiles::tile_size, height);
+            const int h  = y1 - y0 + 2 * k;    // 読む行数. 作業領域の行 r はグリッドの行 y0 - k + r
+
+            for(int i0 = 0; i0 < words; ){
+                if (not active[i0]) { ++i0; continue; }
+                int i1 = i0 + 1;
+                while (i1 < words and i1 - i0 < chunk and active[i1]) ++i1;
+
+                const int n = i1 - i0;
+                const int x = (i0 - 2) * 64;
+
+                // グリッドの左右の端にかかるワードだけを集め, 残りはそのまま写す
+                const int c0 = std::clamp(-x / 64, 0, n + 4);
+                const int c1 = std::clamp((src_.width() - x) / 64, c0, n + 4);
+                for(int r = 0; r < h; ++r){
+                    const uint64_t* row = src_.row(((y0 - k + r) % height + height) % height);
+                    uint64_t*       out = buf[0] + static_cast<size_t>(r) * stride;
+                    for(int c = 0;  c < c0;    ++c) out[c] = _bit_life::gatherWord(src_, row, x + c * 64);
+                    std::copy(row + i0 - 2 + c0, row + i0 - 2 + c1, out + c0);
+                    for(int c = c1; c < n + 4; ++c) out[c] = _bit_life::gatherWord(src_, row, x + c * 64);
+                }
+
+                // 世代 t では上下 t 行ずつ狭い範囲だけが正しい
+                for(int t = 1; t <= k; ++t){
+                    const uint64_t* cur  = buf[(t - 1) & 1];
+                    uint64_t*       next = buf[t & 1];
+                    for(int r = t; r < h - t; ++r){
+                        const size_t o = static_cast<size_t>(r) * stride + 1;
+                        kernel(cur + o - stride, cur + o, cur + o + stride, next + o, 0, n + 2);
+                    }
+                }
+
+                // src_ の最後のワードにはハローのビットが入っているので比べる前に落とす
+                const uint64_t* last = buf[k & 1];
+                const uint64_t* prev = buf[(k - 1) & 1];
+                for(int b = y0; b < y1; ++b){
+                    const size_t    o   = static_cast<size_t>(b - y0 + k) * stride + 2;
+                    const uint64_t* cur = src_.row(b);
+                    uint64_t*       out = dst_.row(b);
+                    for(int j = 0; j < n; ++j){
+                        const int      i    = i0 + j;
+                        const uint64_t mask = (i == words - 1) ? tail : ~uint64_t{0};
+                        const uint64_t w    = last[o + j] & mask;
+                        out[i] = w;
+                        if (w != (cur[i] & mask) or w != (prev[o + j] & mask)) out_.set(i, ty, true);
+                    }
+                }
+                i0 = i1;
+            }
+        }
+    }
+}
+#endif
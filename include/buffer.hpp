@@ -2,6 +2,8 @@
 #define ATPT_BUFFER_HPP
 
 #include <array>
+#include <cstddef>
+#include <utility>
 
 namespace atpt{
  
@@ -24,7 +24,7 @@ namespace atpt{
     template <typename T, size_t N>
     void Buffer<T, N>::timestep (void) const
     {
-        _current = _current++ < N ? _current : _current - N;
+        _current = (_current + 1 < N) ? _current + 1 : 0;
     }
 }
 #endif
@@ -0,0 +1,33 @@
+#ifndef ATPT_CPU_FEATURES_HPP
+#define ATPT_CPU_FEATURES_HPP
+
+// x86 のときだけ SIMD カーネルを組み込む. MSVC は target 属性なしで全 intrinsics を使える
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ATPT_X86 1
+#else
+    #define ATPT_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define ATPT_TARGET(isa_) __attribute__((target(isa_)))
+    #define ATPT_INLINE       inline __attribute__((always_inline))
+#else
+    #define ATPT_TARGET(isa_)
+    #define ATPT_INLINE       __forceinline
+#endif
+
+namespace atpt{
+
+    enum class SimdLevel{
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512,
+    };
+
+    // CPUID (と OS の XSAVE 対応) から使える最上位の命令セットを返す
+    auto detectSimdLevel (void)      -> SimdLevel;
+    auto simdLevelName   (SimdLevel) -> const char*;
+}
+
+#endif
@@ -4,10 +4,15 @@
 #include <array>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <cstddef>
 
 namespace atpt{
  
-    template <typename T>
+    // H > 0 のときは周囲 H セル分のハロー (ゴーストセル) を持つ.
+    // ハローは fillHalo() で既定値に埋め, 内部は row() の行ポインタで分岐なしに走査できる.
+    // その場合 operator [] / vector / begin / end はハローを含む生の格納領域を指す.
+    template <typename T, int H = 0>
     class FreeBoundaryGrid{
          
         //+   Member Variable    +//
@@ -26,6 +31,7 @@ namespace atpt{
         private:
         //_ Constant Function
         inline auto _is_valid_pos (int, int) const -> bool;
+        inline auto _index        (int x_, int y_) const -> size_t { return static_cast<size_t>(y_ + H) * stride() + (x_ + H); }
 
         public:
         //_ Constant Getter
@@ -33,9 +39,12 @@ namespace atpt{
         inline auto operator () (int, int)   const -> const T&;
         inline auto neumann     (int, int)   const ->       std::array<const T*, 5>;
         inline auto moore       (int, int)   const ->       std::array<const T*, 9>;
+               auto row         (int y_)     const -> const T* { return _vector.data() + _index(0, y_); }
 
                auto width  (void) const ->       int                                     { return _width; }
                auto height (void) const ->       int                                     { return _height; }
+               auto stride (void) const ->       int                                     { return _width + 2 * H; }
+               auto halo   (void) const ->       int                                     { return H; }
                auto vector (void) const -> const std::vector<T>&                         { return _vector; }
                auto begin  (void) const ->       typename std::vector<T>::const_iterator { return _vector.begin(); };
                auto end    (void) const ->       typename std::vector<T>::const_iterator { return _vector.end(); };
@@ -44,17 +53,20 @@ namespace atpt{
         //_ Getter
                auto operator [] (size_t id_) -> T& { return _vector[id_]; }
         inline auto operator () (int, int)   -> T&;
+               auto row         (int y_)     -> T* { return _vector.data() + _index(0, y_); }
                auto begin       (void)       -> typename std::vector<T>::iterator { return _vector.begin(); };
                auto end         (void)       -> typename std::vector<T>::iterator { return _vector.end(); };
 
         public:
         //_ Variable Function
-        inline auto resize (int, int) -> int;
+        inline auto resize   (int, int) -> int;
+        inline auto fillHalo (void)     -> void;
     };
 
 
 
-    template <typename T>
+    // ハローの扱いは FreeBoundaryGrid と同じ. fillHalo() は反対側の行・列を巻き込んでコピーする.
+    template <typename T, int H = 0>
     class PeriodicBoundaryGrid{
          
         //+   Member Variable    +//
@@ -70,8 +82,9 @@ namespace atpt{
 
         private:
         //_ Constant Function
-        inline auto _xmod (int) const -> int;
-        inline auto _ymod (int) const -> int;
+        inline auto _xmod  (int) const -> int;
+        inline auto _ymod  (int) const -> int;
+        inline auto _index (int x_, int y_) const -> size_t { return static_cast<size_t>(y_ + H) * stride() + (x_ + H); }
 
         public:
         //_ Constant Getter
@@ -79,9 +92,12 @@ namespace atpt{
         inline auto operator () (int x_, int y_) const -> const T&;
         inline auto neumann     (int x_, int y_) const ->       std::array<const T*, 5>;
         inline auto moore       (int x_, int y_) const ->       std::array<const T*, 9>;
+               auto row         (int y_)         const -> const T* { return _vector.data() + _index(0, y_); }
 
                auto width  (void) const -> int { return _width; }
                auto height (void) const -> int { return _height; }
+               auto stride (void) const -> int { return _width + 2 * H; }
+               auto halo   (void) const -> int { return H; }
                auto vector (void) const -> const std::vector<T>& { return _vector; }
                auto beginv (void) const ->       typename std::vector<T>::const_iterator { return _vector.begin(); };
                auto end    (void) const ->       typename std::vector<T>::const_iterator { return _vector.end(); };
@@ -90,12 +106,14 @@ namespace atpt{
         //_ Getter
                auto operator [] (size_t id_) -> T& { return _vector[id_]; }
         inline auto operator () (int, int) -> T&;
+               auto row         (int y_)   -> T* { return _vector.data() + _index(0, y_); }
                auto begin       (void)     -> typename std::vector<T>::iterator { return _vector.begin(); };
                auto end         (void)     -> typename std::vector<T>::iterator { return _vector.end(); };
   
         public:
         //_ Variable Function
-        inline auto resize (int, int) -> int;
+        inline auto resize   (int, int) -> int;
+        inline auto fillHalo (void)     -> void;
     };
 
 }
@@ -5,11 +5,11 @@
 
 namespace atpt{
 
-    template <typename T>
-    FreeBoundaryGrid<T>::FreeBoundaryGrid (int width_, int height_, const T& dv_)
+    template <typename T, int H>
+    FreeBoundaryGrid<T, H>::FreeBoundaryGrid (int width_, int height_, const T& dv_)
         : _width         (width_)
         , _height        (height_)
-        , _vector        (_width * _height, dv_)
+        , _vector        (static_cast<size_t>(_width + 2 * H) * (_height + 2 * H), dv_)
         , _default_value (dv_)
         , _dummy_value   (_default_value)
     {
@@ -17,8 +17,8 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::_is_valid_pos (int x_, int y_) const
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::_is_valid_pos (int x_, int y_) const
         -> bool
     {
         if (x_ < 0 or x_ > _width - 1 or y_ < 0 or y_ > _height - 1) return false;
@@ -26,18 +26,24 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::operator () (int x_, int y_) const
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::operator () (int x_, int y_) const
         -> const T&
     {
-        return _vector[y_ * _width + x_];
+        return _vector[_index(x_, y_)];
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::neumann (int x_, int y_) const
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::neumann (int x_, int y_) const
         -> std::array<const T*, 5>
     {
+        if constexpr (H > 0) {
+            const T*  c = &_vector[_index(x_, y_)];
+            const int s = stride();
+            return { c - s, c - 1, c, c + 1, c + s };
+        }
+
         std::array<const T*, 5> out{};
 
         const int center = y_ * _width + x_;
@@ -61,10 +67,18 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::moore (int x_, int y_) const
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::moore (int x_, int y_) const
         -> std::array<const T*, 9>
     {
+        if constexpr (H > 0) {
+            const T*  c = &_vector[_index(x_, y_)];
+            const int s = stride();
+            return { c - s - 1, c - s, c - s + 1,
+                     c     - 1, c,     c     + 1,
+                     c + s - 1, c + s, c + s + 1 };
+        }
+
         std::array<const T*, 9> out{};
 
         const size_t center = y_ * _width + x_;
@@ -100,58 +114,104 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::operator () (int x_, int y_) 
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::operator () (int x_, int y_) 
         ->T&
     {
-        return _vector[y_ * _width + x_];
+        return _vector[_index(x_, y_)];
     }
 
 
-    template <typename T>
-    auto FreeBoundaryGrid<T>::resize (int nw_, int nh_)
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::resize (int nw_, int nh_)
         -> int
     {
-        std::vector<T> nvec(nw_ * nh_, _default_value);
-        for(size_t a = 0; a < std::min(_height, nh_); ++a){
-            std::copy(
-                _vector.begin() + a * _width, 
-                _vector.begin() + a * _width + std::min(_width, nw_),
-                nvec.begin() + a * nw_
-            );
+        const int    ostride = stride();
+        const int    nstride = nw_ + 2 * H;
+        const int    rows    = std::min(_height, nh_);
+        const int    cols    = std::min(_width,  nw_);
+        const size_t osize   = _vector.size();
+        const size_t nsize   = static_cast<size_t>(nstride) * (nh_ + 2 * H);
+
+        // 確保済みの中に収まる間は取り直さない. 拡がるときは余裕を持って取っておく (窓のドラッグで何度も拡がるので)
+        if (nsize > _vector.capacity()) _vector.reserve(nsize + nsize / 2);
+        if (nsize > osize)              _vector.resize(nsize, _default_value);
+
+        // その場で行を詰め直す. 行の間隔が拡がるなら下の行から, 狭まるなら上の行から動かせば, まだ動かしていない行を潰さない
+        T* const d = _vector.data();
+        if (nstride > ostride) {
+            for(int a = rows - 1; a >= 0; --a){
+                T* const src = d + static_cast<size_t>(a + H) * ostride + H;
+                std::copy_backward(src, src + cols, d + static_cast<size_t>(a + H) * nstride + H + cols);
+            }
+        }else if (nstride < ostride) {
+            for(int a = 0; a < rows; ++a){
+                T* const src = d + static_cast<size_t>(a + H) * ostride + H;
+                std::copy(src, src + cols, d + static_cast<size_t>(a + H) * nstride + H);
+            }
+        }
+        if (nsize < osize) _vector.resize(nsize);
+
+        // 写してこなかった所 (新しい列と行, ハロー) を既定値に戻す
+        for(int a = -H; a < nh_ + H; ++a){
+            T* const r = d + static_cast<size_t>(a + H) * nstride;
+            if (a < 0 or a >= rows) {
+                std::fill(r, r + nstride, _default_value);
+            }else{
+                std::fill(r,            r + H,       _default_value);
+                std::fill(r + H + cols, r + nstride, _default_value);
+            }
         }
 
-        _vector = std::move(nvec);
         _width  = nw_;
         _height = nh_;
-        
+
         return 0;
     }
 
 
+    template <typename T, int H>
+    auto FreeBoundaryGrid<T, H>::fillHalo (void)
+        -> void
+    {
+        if constexpr (H > 0) {
+            const int s = stride();
+            for(int k = 1; k <= H; ++k){
+                std::fill(row(-k) - H,           row(-k) - H + s,           _default_value);
+                std::fill(row(_height - 1 + k) - H, row(_height - 1 + k) - H + s, _default_value);
+            }
+            for(int b = 0; b < _height; ++b){
+                T* r = row(b);
+                std::fill(r - H,      r,              _default_value);
+                std::fill(r + _width, r + _width + H, _default_value);
+            }
+        }
+    }
+
+
 
 
-    template <typename T>
-    PeriodicBoundaryGrid<T>::PeriodicBoundaryGrid (int width_, int height_, const T& dv_)
+    template <typename T, int H>
+    PeriodicBoundaryGrid<T, H>::PeriodicBoundaryGrid (int width_, int height_, const T& dv_)
         : _width         (width_)
         , _height        (height_)
-        , _vector        (_width * _height, dv_)
+        , _vector        (static_cast<size_t>(_width + 2 * H) * (_height + 2 * H), dv_)
         , _default_value (dv_)
     {
         return;
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::_xmod (int x_) const
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::_xmod (int x_) const
         -> int
     {
         return ((x_ % _width) + _width) % _width;
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::_ymod (int y_) const
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::_ymod (int y_) const
         -> int
     {
         return ((y_ % _height) + _height) % _height;
@@ -159,18 +219,24 @@ namespace atpt{
 
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::operator () (int x_, int y_) const
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::operator () (int x_, int y_) const
         -> const T&
     {
-        return _vector[y_ * _width + x_];
+        return _vector[_index(x_, y_)];
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::neumann (int x_, int y_) const
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::neumann (int x_, int y_) const
         -> std::array<const T*, 5>
     {
+        if constexpr (H > 0) {
+            const T*  c = &_vector[_index(x_, y_)];
+            const int s = stride();
+            return { c - s, c - 1, c, c + 1, c + s };
+        }
+
         std::array<const T*, 5> out{};
     
         int xm1 = _xmod(x_ - 1);
@@ -188,10 +254,18 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::moore (int x_, int y_) const
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::moore (int x_, int y_) const
         -> std::array<const T*, 9>
     {
+        if constexpr (H > 0) {
+            const T*  c = &_vector[_index(x_, y_)];
+            const int s = stride();
+            return { c - s - 1, c - s, c - s + 1,
+                     c     - 1, c,     c     + 1,
+                     c + s - 1, c + s, c + s + 1 };
+        }
+
         std::array<const T*, 9> out{};
     
         int xm1 = _xmod(x_ - 1);
@@ -213,31 +287,86 @@ namespace atpt{
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::operator () (int x_, int y_) 
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::operator () (int x_, int y_) 
         ->T&
     {
-        return _vector[y_ * _width + x_];
+        return _vector[_index(x_, y_)];
     }
 
 
-    template <typename T>
-    auto PeriodicBoundaryGrid<T>::resize (int nw_, int nh_)
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::resize (int nw_, int nh_)
         -> int
     {
-        std::vector<T> nvec(nw_ * nh_, _default_value);
-        for(size_t a = 0; a < std::min(_height, nh_); ++a){
-            std::copy(
-                _vector.begin() + a * _width, 
-                _vector.begin() + a * _width + std::min(_width, nw_),
-                nvec.begin() + a * nw_
-            );
+        const int    ostride = stride();
+        const int    nstride = nw_ + 2 * H;
+        const int    rows    = std::min(_height, nh_);
+        const int    cols    = std::min(_width,  nw_);
+        const size_t osize   = _vector.size();
+        const size_t nsize   = static_cast<size_t>(nstride) * (nh_ + 2 * H);
+
+        // 確保済みの中に収まる間は取り直さない. 拡がるときは余裕を持って取っておく (窓のドラッグで何度も拡がるので)
+        if (nsize > _vector.capacity()) _vector.reserve(nsize + nsize / 2);
+        if (nsize > osize)              _vector.resize(nsize, _default_value);
+
+        // その場で行を詰め直す. 行の間隔が拡がるなら下の行から, 狭まるなら上の行から動かせば, まだ動かしていない行を潰さない
+        T* const d = _vector.data();
+        if (nstride > ostride) {
+            for(int a = rows - 1; a >= 0; --a){
+                T* const src = d + static_cast<size_t>(a + H) * ostride + H;
+                std::copy_backward(src, src + cols, d + static_cast<size_t>(a + H) * nstride + H + cols);
+            }
+        }else if (nstride < ostride) {
+            for(int a = 0; a < rows; ++a){
+                T* const src = d + static_cast<size_t>(a + H) * ostride + H;
+                std::copy(src, src + cols, d + static_cast<size_t>(a + H) * nstride + H);
+            }
+        }
+        if (nsize < osize) _vector.resize(nsize);
+
+        // 写してこなかった所 (新しい列と行, ハロー) を既定値に戻す
+        for(int a = -H; a < nh_ + H; ++a){
+            T* const r = d + static_cast<size_t>(a + H) * nstride;
+            if (a < 0 or a >= rows) {
+                std::fill(r, r + nstride, _default_value);
+            }else{
+                std::fill(r,            r + H,       _default_value);
+                std::fill(r + H + cols, r + nstride, _default_value);
+            }
         }
 
-        _vector = std::move(nvec);
         _width  = nw_;
         _height = nh_;
+
+        fillHalo();
         return 0;
     }
+
+
+    template <typename T, int H>
+    auto PeriodicBoundaryGrid<T, H>::fillHalo (void)
+        -> void
+    {
+        if constexpr (H > 0) {
+            if (_width == 0 or _height == 0) return;
+
+            for(int b = 0; b < _height; ++b){
+                T* r = row(b);
+                for(int k = 1; k <= H; ++k){
+                    r[-k]             = r[_xmod(-k)];
+                    r[_width - 1 + k] = r[_xmod(_width - 1 + k)];
+                }
+            }
+
+            const int s = stride();
+            for(int k = 1; k <= H; ++k){
+                const T* top    = row(_ymod(-k)) - H;
+                const T* bottom = row(_ymod(_height - 1 + k)) - H;
+                std::copy(top,    top    + s, row(-k) - H);
+                std::copy(bottom, bottom + s, row(_height - 1 + k) - H);
+            }
+        }
+    }
 }
 #endif
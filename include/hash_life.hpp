@@ -0,0 +1,84 @@
+#ifndef ATPT_HASH_LIFE_HPP
+#define ATPT_HASH_LIFE_HPP
+
+#include <bit_grid.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace atpt{
+
+    // B3/S23 の HashLife.
+    // 四分木のノードはハッシュコンスで一意化し, RESULT (中央の半分を 2^k 世代進めたもの) をノードにメモする.
+    // ルートは原点中心で, level L のルートは [-2^(L-1), 2^(L-1)) の正方形を覆う.
+    // ノード数が上限を超えたら, advance の前と RESULT の再帰の途中で, ルートと計算中のノードから辿れないノードを回収する.
+    // 計算中のノードだけで上限を超えるときは, 回収後の 2倍まで上限を緩める (回収し続けて進まなくなるのを防ぐ).
+    class HashLife{
+
+        public:
+        using Index = uint32_t;
+
+        private:
+        struct Node{
+            Index    nw, ne, sw, se;
+            Index    result;
+            uint8_t  level;
+            bool     mark;
+            uint64_t population;
+        };
+
+        //+   Member Variable    +//
+        std::vector<Node>  _nodes;
+        std::vector<Index> _free;
+        std::vector<Index> _table;
+        std::vector<Index> _empty;
+        std::vector<Index> _roots;
+        size_t             _live;
+        size_t             _max_nodes;
+        size_t             _limit;
+        Index              _root;
+        int                _step_log;
+        uint64_t           _generation;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        explicit HashLife (size_t = size_t{1} << 21);
+
+        //_ Constant Getter
+        auto generation (void) const -> uint64_t { return _generation; }
+        auto population (void) const -> uint64_t { return _nodes[_root].population; }
+        auto level      (void) const -> int      { return _nodes[_root].level; }
+        auto nodeCount  (void) const -> size_t   { return _live; }
+        auto maxNodes   (void) const -> size_t   { return _max_nodes; }
+
+        // (x0_, y0_) を左上とする w_ x h_ ピクセルの窓を描く. 1ピクセル = 2^scale_log_ x 2^scale_log_ セル
+        auto rasterize (int64_t x0_, int64_t y0_, int w_, int h_, int scale_log_, uint32_t* pixels_, uint32_t on_, uint32_t off_) const -> void;
+
+        //_ Variable Function
+        auto clear       (void)                                           -> void;
+        auto load        (const PeriodicBoundaryBitGrid&, int64_t, int64_t) -> void;
+        auto advance     (int)                                            -> int;
+        auto collect     (void)                                           -> void;
+        auto setMaxNodes (size_t n_)                                      -> void { _max_nodes = n_; }
+
+        private:
+        //_ Inner Function
+        auto _hash       (Index, Index, Index, Index) const -> size_t;
+        auto _join       (Index, Index, Index, Index)       -> Index;
+        auto _insert     (Index)                            -> void;
+        auto _rehash     (size_t)                           -> void;
+        auto _emptyNode  (int)                              -> Index;
+        auto _center     (Index)                            -> Index;
+        auto _base       (Index)                            -> Index;
+        auto _result     (Index)                            -> Index;
+        auto _expand     (void)                             -> void;
+        auto _clearMemo  (void)                             -> void;
+        auto _mark       (Index)                            -> void;
+        auto _sweep      (void)                             -> void;
+        auto _build      (int, int64_t, int64_t, const PeriodicBoundaryBitGrid&, int64_t, int64_t) -> Index;
+        auto _raster     (Index, int64_t, int64_t, int64_t, int64_t, int, int, int, uint32_t*, uint32_t) const -> void;
+    };
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef ATPT_HASH_LIFE_CA_HPP
+#define ATPT_HASH_LIFE_CA_HPP
+
+#include <panel.hpp>
+#include <hash_life.hpp>
+#include <texture.hpp>
+#include <triple_buffer.hpp>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // HashLife で 1フレームあたり 2^step_log 世代進める Conway CA.
+    // LEFT / RIGHT で step_log, PAGEUP / PAGEDOWN で縮尺 (1ピクセル = 2^scale_log セル) を変える
+    class HashLifeCA : public Panel{
+
+        //+   Member Variable    +//
+        Texture                  _texture;
+        TripleBuffer<PixelFrame> _frames;
+        HashLife                 _life;
+        uint64_t                 _generation;
+        uint32_t                 _seed;
+        int                      _step_log;
+        int                      _scale_log;
+        bool                     _loaded;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        HashLifeCA (SDL_Window*, uint32_t, size_t = size_t{1} << 21);
+
+        //_ Getter
+        auto seed (void) -> uint32_t        { return _seed; }
+        auto life (void) -> const HashLife& { return _life; }
+
+        //_ Variable Function
+        auto _resize     (int, int)         -> int override;
+        auto _step       (bool, int)        -> int override;
+        auto _present    (void)             -> int override;
+        auto _event      (const SDL_Event&) -> int override;
+        auto _activate   (void)             -> int override;
+        auto _deactivate (void)             -> int override;
+
+    };
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef ATPT_LFSR_HPP
+#define ATPT_LFSR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace atpt{
+
+    // BadNoise の 32bit LFSR (タップ 0 と 2, 右シフトで最上位に帰還). 1ステップの出力は進めた後の bit 0.
+    // タップが 1ワードに収まっているので 32ステップ分はシフトと xor 数回でまとめて進められる.
+    // 遷移は GF(2) 上の 32x32 行列なので, その 2^i 乗を持っておけば任意のステップ数へ飛べる
+    class Lfsr32{
+
+        //+   Member Variable    +//
+        uint32_t _state;
+
+        public:
+        // 列 j = 行列 x e_j
+        using Matrix = std::array<uint32_t, 32>;
+
+        //+   Member Function    +//
+        //_ Constructor
+        explicit Lfsr32 (uint32_t state_) : _state { state_ } { return; }
+
+        //_ Constant Getter
+        auto state (void) const -> uint32_t { return _state; }
+
+        //_ Variable Function
+        // 1ステップ進めて出力ビットを返す (元の BadNoise と同じ)
+        auto step (void)
+            -> uint32_t
+        {
+            const uint32_t tmp = ((_state >> 0) ^ (_state >> 2)) & 1;
+            _state = (_state >> 1) | (tmp << 31);
+            return _state & 1;
+        }
+
+        // 32ステップ進め, その出力を下位ビットから順に返す
+        auto next32 (void)
+            -> uint32_t
+        {
+            uint32_t t = _state ^ (_state >> 2);
+            t ^= (t & 3u) << 30;
+            const uint32_t out = (_state >> 1) | (t << 31);
+            _state = t;
+            return out;
+        }
+
+        auto next64 (void)
+            -> uint64_t
+        {
+            const uint64_t lo = next32();
+            return lo | (static_cast<uint64_t>(next32()) << 32);
+        }
+
+        auto set  (uint32_t state_) -> void { _state = state_; }
+        auto jump (uint64_t)        -> void;
+    };
+}
+
+#endif
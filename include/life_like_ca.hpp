@@ -0,0 +1,83 @@
+#ifndef ATPT_LIFE_LIKE_CA_HPP
+#define ATPT_LIFE_LIKE_CA_HPP
+
+#include <panel.hpp>
+#include <bit_grid.hpp>
+#include <active_tiles.hpp>
+#include <buffer.hpp>
+#include <life_like_rule.hpp>
+#include <palette.hpp>
+#include <pixel_buffer.hpp>
+#include <step_task.hpp>
+#include <texture.hpp>
+#include <triple_buffer.hpp>
+#include <vector>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // Rule (B/S 記法の Life-like な規則) で動く CA. 規則ごとにビット並列カーネルがコンパイル時に生成される.
+    // 変化のあったタイルの近傍だけを計算し, テクスチャ転送も変化したタイルだけにする.
+    // セルはビットグリッドの行をそのまま R8 テクスチャ (1 texel = 8セル) に写して送り, 色は fs_palette.sc が引く.
+    // フレームはタイルごとに最後に変わった世代を持って TripleBuffer で渡るので, 描画が世代を飛ばしても差分だけで追いつける.
+    // 1世代が step() の持ち時間に収まらないほど大きなグリッドでは, タイル行の塊ごとに区切って何回かに分けて進める.
+    // 表示しない世代が続くときは bitLifeStepBlocked でタイルごとに何世代かをキャッシュの中で進める
+    template <typename Rule>
+    class LifeLikeCA : public Panel{
+        
+        //+   Static Variable    +//
+        // C キーで順に切り替える配色 (0: 死, 1: 生)
+        static constexpr uint32_t palettes[][2] = {
+            { 0xFF000000u, 0xFF13A00Eu },
+            { 0xFF000000u, 0xFFFFB000u },
+            { 0xFFF0F0F0u, 0xFF202020u },
+        };
+
+        //+   Member Variable    +//
+        bgfx::UniformHandle                 _sh;
+        Texture                             _texture;
+        StateBuffer                         _states;
+        TripleBuffer<StateFrame>            _frames;
+        Palette                             _palette;
+        size_t                              _palette_index;
+        Buffer<PeriodicBoundaryBitGrid, 2>  _grid_buf;
+        Buffer<ActiveTiles, 2>              _tile_buf;
+        std::vector<uint64_t>               _stamps;
+        uint64_t                            _generation;
+        uint64_t                            _shown;
+        uint32_t                            _seed;
+        StepTask                            _task;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        LifeLikeCA (SDL_Window*, uint32_t);
+
+        //_ Getter
+        auto seed  (void) -> uint32_t           { return _seed; }
+        auto tiles (void) -> const ActiveTiles& { return _tile_buf.template get<1>(); }
+        
+        //_ Variable Function
+        auto _resize     (int, int)         -> int override;
+        auto _step       (bool, int)        -> int override;
+        auto _present    (void)             -> int override;
+        auto _event      (const SDL_Event&) -> int override;
+        auto _activate   (void)             -> int override;
+        auto _deactivate (void)             -> int override;
+
+        private:
+        //_ Inner Function
+        auto _fit           (void)               -> void;
+        auto _abandon       (void)               -> void;
+        auto _pack          (const PeriodicBoundaryBitGrid&, StateFrame&, int, int, int, int) -> void;
+        auto _stampChanged  (const ActiveTiles&, int) -> void;
+        auto _generate      (bool, int)               -> StepTask;
+    };
+
+
+    using ConwayCA = LifeLikeCA<Conway>;
+}
+
+#include "life_like_ca.inl"
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef ATPT_LIFE_LIKE_CA_INL
+#define ATPT_LIFE_LIKE_CA_INL
+
+#include "life_like_ca.hpp"
+#include <bit_life.hpp>
+#include <random_bits.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+namespace atpt{
+
+    // グリッドも GPU の資源も最初の activate() まで作らない
+    template <typename Rule>
+    LifeLikeCA<Rule>::LifeLikeCA (SDL_Window* wd_, uint32_t seed_)
+        : Panel          ( "LifeLikeCA " + std::string(Rule::notation()), wd_, "shaders/fs_palette.bin" )
+        , _sh            ( BGFX_INVALID_HANDLE )
+        , _texture       ( "u_tex0", bgfx::TextureFormat::R8 )
+        , _states        ( 0, 0 )
+        , _frames        ( )
+        , _palette       { palettes[0][0], palettes[0][1] }
+        , _palette_index { 0 }
+        , _grid_buf      ( 0, 0 )
+        , _tile_buf      ( 0, 0 )
+        , _stamps        ( )
+        , _generation    { 0 }
+        , _shown         { 0 }
+        , _seed          { seed_ }
+        , _task          ( )
+    {
+        return;
+    }
+
+    
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_resize (int o_width_, int o_height_)
+        -> int
+    {
+        _fit();
+        _texture.resize(_states.width(), _states.height());
+        
+        return 0;
+    }
+
+
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_activate (void)
+        -> int
+    {
+        // 各セルは (seed, 世代 0, 位置) だけで決まるので, 帯ごとに並列に埋めても同じ盤面になる
+        PeriodicBoundaryBitGrid& grid = _grid_buf.template get<1>();
+        if (grid.width() == 0 and grid.height() == 0) {
+            _fit();
+            randomizeGrid(_grid_buf.template get<1>(), _seed);
+        }else if (grid.width() != _width or grid.height() != _height) {
+            _fit();
+        }
+        _states.resize(grid.words() * 8, grid.height());
+
+        _sh = bgfx::createUniform("u_state", bgfx::UniformType::Vec4);
+        _texture.resize(_states.width(), _states.height());
+        _shown = 0;
+
+        return 0;
+    }
+
+
+    // グリッド (と状態) は残し, フレームと転送用の置き場を手放す. 次に出すフレームは全面を写し直す
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_deactivate (void)
+        -> int
+    {
+        _abandon();
+
+        if (bgfx::isValid(_sh)) bgfx::destroy(_sh);
+        _sh = BGFX_INVALID_HANDLE;
+        _texture.destroy();
+        _palette.destroy();
+        _frames.reset();
+        _states.release();
+        
+        return 0;
+    }
+
+
+    // 世代の途中で持ち時間が切れていれば続きは次の呼び出しで進める
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_step (bool publish_, int count_)
+        -> int
+    {
+        if (not _task.pending()) _task = _generate(publish_, count_);
+        return _task.resume() ? 0 : Panel::yielded;
+    }
+
+
+    // count_ 世代をタイル行の塊ごとに進め, 塊の間で持ち時間を見て切れていれば co_yield で手を離す.
+    // 止まっている間も src / 前のフレームには触らないので, 描画はその前に出来上がった世代を出し続ける.
+    // グリッドを作り直す _resize は途中の世代を捨てる
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_generate (bool publish_, int count_)
+        -> StepTask
+    {
+              ThreadPool& pool  = ThreadPool::shared();
+        const int         slice = static_cast<int>(pool.size());    // 1回にスレッド数ぶんのタイル行
+
+        // 表示しない世代はグリッドだけを進める. 変わったタイルの印は残るので, 次に出すフレームがまとめて追いつく.
+        // 2世代以上続くならタイルごとに最大 tile_size 世代をまとめて進め, グリッドをなめる回数を減らす
+        const int ahead = publish_ ? count_ - 1 : count_;
+        for(int rest = ahead; rest > 0; ){
+            if (rest < ahead and _expired()) co_yield {};
+
+            const PeriodicBoundaryBitGrid& src = _grid_buf.template get<1>();
+                  PeriodicBoundaryBitGrid& dst = _grid_buf.template get<0>();
+            const ActiveTiles&             in  = _tile_buf.template get<1>();
+                  ActiveTiles&             out = _tile_buf.template get<0>();
+            const int                      k   = std::min(rest, ActiveTiles::tile_size);
+
+            for(int t = 0; t < in.tilesY(); t += slice){
+                if (t > 0 and _expired()) co_yield {};
+                pool.parallelFor(t, std::min(t + slice, in.tilesY()), 1, [&](int t0_, int t1_){
+                    if (k == 1) bitLifeStepTiles<Rule>(src, dst, in, out, t0_, t1_);
+                    else        bitLifeStepBlocked<Rule>(src, dst, in, out, t0_, t1_, k);
+                });
+            }
+            dst.fillHalo();
+            _stampChanged(out, k);
+
+            _grid_buf.timestep();
+            _tile_buf.timestep();
+            rest -= k;
+        }
+        if (not publish_) co_return;
+        if (ahead > 0 and _expired()) co_yield {};
+
+        // 最後の 1世代は色付けと同じパスで進める
+        const PeriodicBoundaryBitGrid& src = _grid_buf.template get<1>();
+              PeriodicBoundaryBitGrid& dst = _grid_buf.template get<0>();
+        const ActiveTiles&             in  = _tile_buf.template get<1>();
+              ActiveTiles&             out = _tile_buf.template get<0>();
+
+        StateFrame& f = _frames.back();
+
+        // 書き手に戻ってきたフレームは数世代前のままなので, 先に src (今の世代) へ追いつかせる.
+        // 大きさが変わっていれば全面を写す
+        if (f.width != src.words() * 8 or f.height != src.height()) {
+            f.width  = src.words() * 8;
+            f.height = src.height();
+            f.tile_w = 8;
+            f.tile_h = ActiveTiles::tile_size;
+            f.pixels.assign(static_cast<size_t>(f.width) * f.height, 0);
+            f.generation = 0;
+        }
+        if (f.generation == 0) {
+            pool.parallelBands(src, [&](int b0_, int b1_){ _pack(src, f, 0, b0_, src.words(), b1_); });
+        }else{
+            pool.parallelFor(0, in.tilesY(), 1, [&](int t0_, int t1_){
+                for(int ty = t0_; ty < t1_; ++ty){
+                    const int y0 = ty << ActiveTiles::tile_log;
+                    const int y1 = std::min(y0 + ActiveTiles::tile_size, src.height());
+                    for(int tx = 0; tx < in.tilesX(); ++tx){
+                        if (_stamps[static_cast<size_t>(ty) * in.tilesX() + tx] > f.generation) _pack(src, f, tx, y0, tx + 1, y1);
+                    }
+                }
+            });
+        }
+
+        // 各帯は自分のタイル行だけを書くので, 結果はスレッド数によらず逐次版と一致する.
+        // 変わったワードはキャッシュにあるうちにフレームへ写す (グリッドを2度なめない)
+        for(int t = 0; t < in.tilesY(); t += slice){
+            if (t > 0 and _expired()) co_yield {};
+            pool.parallelFor(t, std::min(t + slice, in.tilesY()), 1, [&](int t0_, int t1_){
+                bitLifeStepTiles<Rule>(src, dst, in, out, t0_, t1_, [&f](int y_, int i_, uint64_t w_){
+                    std::memcpy(f.pixels.data() + static_cast<size_t>(y_) * f.width + i_ * 8, &w_, sizeof(w_));
+                });
+            });
+        }
+        dst.fillHalo();
+        _stampChanged(out, 1);
+
+        f.generation = _generation;
+        f.stamps     = _stamps;
+        _frames.publish();
+
+        _grid_buf.timestep();
+        _tile_buf.timestep();
+
+        co_return;
+    }
+
+
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_present (void)
+        -> int
+    {
+        // 見えている範囲で, 前に出した世代より後に変わったタイルの矩形だけを転送する. 範囲が動いたら範囲を丸ごと写し直す
+        if (_moved) _shown = 0;
+        if ((_frames.update() or _moved) and _states.uploadFrame(_frames.front(), _shown, _texture.handle(), _visibleTexels(8))) _shown = _frames.front().generation;
+
+        const float state[4] = { static_cast<float>(_width), 1.0f, 0.0f, static_cast<float>(_height) };
+        _texture.bind(0);
+        bgfx::setUniform(_sh, state);
+        _palette.bind(1);
+
+        return 0;
+    }
+
+
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_event (const SDL_Event& e_)
+        -> int
+    {
+        // 配色の切り替えはパレットを送り直すだけで, セルは描き直さない
+        if (e_.type == SDL_KEYDOWN and e_.key.keysym.sym == SDLK_c) {
+            _palette_index = (_palette_index + 1) % std::size(palettes);
+            _palette.assign({ palettes[_palette_index][0], palettes[_palette_index][1] });
+        }
+        return 0;
+    }
+
+
+    // グリッド, タイル, 印, 状態の置き場を今の窓の大きさに合わせる. 途中まで進めた世代は古い大きさのまま書いているので捨てる
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_fit (void)
+        -> void
+    {
+        _abandon();
+
+        _grid_buf.template get<0>().resize(_width, _height);
+        _grid_buf.template get<1>().resize(_width, _height);
+        _tile_buf.template get<0>().resize(_width, _height);
+        _tile_buf.template get<1>().resize(_width, _height);
+        _stamps.assign(static_cast<size_t>(_tile_buf.template get<0>().tilesX()) * _tile_buf.template get<0>().tilesY(), 0);
+        _states.resize(_grid_buf.template get<0>().words() * 8, _height);
+        _shown = 0;
+    }
+
+
+    // 途中まで進めた世代を捨てる. 途中で止めた bitLifeStepBlocked は, 1世代では変わらないタイルにも何世代か先を
+    // dst に書いていることがあるので, 次のステップには全タイルを計算させて dst を書き直す
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_abandon (void)
+        -> void
+    {
+        if (_task.pending()) _tile_buf.template get<1>().markAll();
+        _task.reset();
+    }
+
+
+    // 世代を count_ 進め, tiles_ で変わったタイルにその世代を記す
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_stampChanged (const ActiveTiles& tiles_, int count_)
+        -> void
+    {
+        _generation += count_;
+        for(int ty = 0; ty < tiles_.tilesY(); ++ty){
+            for(int tx = 0; tx < tiles_.tilesX(); ++tx){
+                if (tiles_.changed(tx, ty)) _stamps[static_cast<size_t>(ty) * tiles_.tilesX() + tx] = _generation;
+            }
+        }
+    }
+
+
+    // ワード [w0_, w1_) x 行 [y0_, y1_) のビットをそのまま frame_ に写す
+    template <typename Rule>
+    auto LifeLikeCA<Rule>::_pack (const PeriodicBoundaryBitGrid& grid_, StateFrame& frame_, int w0_, int y0_, int w1_, int y1_)
+        -> void
+    {
+        for(int b = y0_; b < y1_; ++b){
+            std::memcpy(frame_.pixels.data() + static_cast<size_t>(b) * frame_.width + w0_ * 8, grid_.row(b) + w0_, static_cast<size_t>(w1_ - w0_) * sizeof(uint64_t));
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef ATPT_LIFE_LIKE_RULE_HPP
+#define ATPT_LIFE_LIKE_RULE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace atpt{
+
+    // Life-like な規則 B/S. Birth_ / Survive_ のビット n が立っていれば近傍 n 個で誕生 / 生存.
+    // 表や記法はすべてコンパイル時に展開される
+    template <uint16_t Birth_, uint16_t Survive_>
+    struct LifeLikeRule{
+
+        static_assert(Birth_ < (1u << 9) and Survive_ < (1u << 9), "neighbour counts are 0..8");
+
+        //+   Static Variable    +//
+        static constexpr uint16_t birth   = Birth_;
+        static constexpr uint16_t survive = Survive_;
+
+        // (中心, 近傍の和) -> 次の状態. index = center * 9 + sum
+        static constexpr std::array<uint8_t, 18> table = []{
+            std::array<uint8_t, 18> t{};
+            for(int n = 0; n < 9; ++n){
+                t[n]     = (Birth_   >> n) & 1u;
+                t[9 + n] = (Survive_ >> n) & 1u;
+            }
+            return t;
+        }();
+
+        static constexpr std::array<char, 24> _notation = []{
+            std::array<char, 24> s{};
+            size_t i = 0;
+            s[i++] = 'B';
+            for(int n = 0; n < 9; ++n) if ((Birth_   >> n) & 1u) s[i++] = static_cast<char>('0' + n);
+            s[i++] = '/';
+            s[i++] = 'S';
+            for(int n = 0; n < 9; ++n) if ((Survive_ >> n) & 1u) s[i++] = static_cast<char>('0' + n);
+            return s;
+        }();
+
+        //+   Static Function    +//
+        static constexpr auto next     (bool center_, int sum_) -> bool             { return table[(center_ ? 9 : 0) + sum_]; }
+        static constexpr auto notation (void)                   -> std::string_view { return std::string_view(_notation.data()); }
+    };
+
+
+    // "B36/S23" のような文字列をテンプレート引数に取るための型
+    template <size_t N>
+    struct RuleString{
+
+        char str[N];
+
+        constexpr RuleString (const char (&s_)[N])
+        {
+            for(size_t i = 0; i < N; ++i) str[i] = s_[i];
+        }
+    };
+
+
+    // key_ ('B' か 'S') の後に続く数字をビットマスクにする. 書式が不正ならコンパイルエラー
+    constexpr auto parseRuleMask (std::string_view s_, char key_)
+        -> uint16_t
+    {
+        const char lower = static_cast<char>(key_ - 'A' + 'a');
+
+        uint16_t mask  = 0;
+        bool     found = false;
+        for(size_t i = 0; i < s_.size(); ++i){
+            if (s_[i] != key_ and s_[i] != lower) continue;
+            found = true;
+            for(++i; i < s_.size() and s_[i] != '/'; ++i){
+                if (s_[i] < '0' or s_[i] > '8') throw std::invalid_argument("rule string: neighbour counts are 0..8");
+                mask |= static_cast<uint16_t>(1u << (s_[i] - '0'));
+            }
+            break;
+        }
+
+        if (not found) throw std::invalid_argument("rule string: missing B or S part");
+        return mask;
+    }
+
+
+    template <RuleString S>
+    using LifeLikeRuleOf = LifeLikeRule<parseRuleMask(S.str, 'B'), parseRuleMask(S.str, 'S')>;
+
+
+    //+   Named Rules    +//
+    using Conway      = LifeLikeRuleOf<"B3/S23">;
+    using HighLife    = LifeLikeRuleOf<"B36/S23">;
+    using DayAndNight = LifeLikeRuleOf<"B3678/S34678">;
+    using Seeds       = LifeLikeRuleOf<"B2/S">;
+}
+
+#endif
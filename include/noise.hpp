@@ -2,35 +2,48 @@
 #define ATPT_NOISE_HPP
 
 #include <panel.hpp>
+#include <palette.hpp>
+#include <pixel_buffer.hpp>
+#include <random_bits.hpp>
+#include <texture.hpp>
+#include <triple_buffer.hpp>
 #include <random>
 #include <bgfx/bgfx.h>
 
 namespace atpt{
  
+    // 毎フレーム全セルを乱数で塗る. 乱数はワード単位で詰めた 1bit のフレームへ直接書き, 色は fs_palette.sc が引く
     class Noise : public Panel{
         
         //+   Member Variable    +//
-        bgfx::UniformHandle   _uh;
-        bgfx::TextureHandle   _th;
-        std::vector<uint32_t> _pixels;
-        uint32_t              _seed;
-        std::mt19937          _mt;
+        bgfx::UniformHandle      _sh;
+        Texture                  _texture;
+        StateBuffer              _states;
+        TripleBuffer<StateFrame> _frames;
+        Palette                  _palette;
+        RandomEngine             _engine;
+        uint64_t                 _generation;
+        uint32_t                 _seed;
+        std::mt19937             _mt;
+        Xoshiro256x4             _xs;
 
         public:
         //+   Member Function    +//
         //_ Constructor
-        Noise (SDL_Window*, uint32_t);
+        Noise (SDL_Window*, uint32_t, RandomEngine = RandomEngine::Xoshiro);
 
         //_ Getter
-        auto seed (void) -> uint32_t { return _seed; }
+        auto seed   (void) -> uint32_t     { return _seed; }
+        auto engine (void) -> RandomEngine { return _engine; }
         
         //_ Variable Function
-        auto _resize  (int, int)         -> int override;
-        auto _draw    (void)             -> int override;
-        auto _event   (const SDL_Event&) -> int override;
-        auto _destroy (void)             -> int override;
-
+        auto _resize     (int, int)         -> int override;
+        auto _step       (bool, int)        -> int override;
+        auto _present    (void)             -> int override;
+        auto _event      (const SDL_Event&) -> int override;
+        auto _activate   (void)             -> int override;
+        auto _deactivate (void)             -> int override;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,41 @@
+#ifndef ATPT_PALETTE_HPP
+#define ATPT_PALETTE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // 状態の番号 (0-255) から色 (BGRA8) を引く 256x1 のテクスチャ. fs_palette.sc がこれを引くので,
+    // パネルは状態だけを R8 (や詰めた 1bit) で転送すればよく, 配色の切り替えも 1KB を送り直すだけで済む
+    class Palette{
+
+        //+   Member Variable    +//
+        std::array<uint32_t, 256> _colors;
+        bgfx::TextureHandle       _th;
+        bgfx::UniformHandle       _uh;
+        bool                      _dirty;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        Palette (std::initializer_list<uint32_t>);
+
+        Palette (const Palette&)             = delete;
+        Palette& operator = (const Palette&) = delete;
+
+        //_ Constant Getter
+        auto operator [] (size_t i_) const -> uint32_t { return _colors[i_]; }
+
+        //_ Variable Function
+        auto set     (size_t, uint32_t)                -> void;
+        auto assign  (std::initializer_list<uint32_t>) -> void;
+        auto bind    (uint8_t)                         -> void;
+        auto destroy (void)                            -> void;
+    };
+}
+
+#endif
@@ -2,26 +2,54 @@
 #define ATPT_PANEL_HPP
 
 #include <SDL2/SDL_events.h>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <filesystem>
 #include <bgfx/bgfx.h>
+#include <pixel_buffer.hpp>
 
 namespace atpt{
 
     class Panel{
 
+        //+    Static Variable    +//
+        static uint32_t _reset_flags;
+
+        public:
+        // _step が世代の途中で持ち時間を使い切って返したとき. 次の step() で続きから進める
+        static constexpr int yielded = 2;
+
+        // 拡大の上限 (窓の画素 / セル)
+        static constexpr double max_zoom = 256.0;
+
         protected:
+        using clock = std::chrono::steady_clock;
+
         //+    Member Variable    +//
         const std::string              _name;
               SDL_Window*              _wh;
+        const std::filesystem::path    _fs_path;
               int                      _width;
               int                      _height;
-              bgfx::ShaderHandle       _vsh;
-              bgfx::ShaderHandle       _fsh;
+              bgfx::ViewId             _view;
+              int                      _x;
+              int                      _y;
+              int                      _view_width;
+              int                      _view_height;
+              int                      _cell_size;
+              int                      _grid_width;
+              int                      _grid_height;
+              double                   _cam_x;
+              double                   _cam_y;
+              double                   _zoom;
+              PixelRect                _visible;
+              bool                     _moved;
               bgfx::ProgramHandle      _ph;
-              bgfx::VertexBufferHandle _vbh;
-              bgfx::IndexBufferHandle  _ibh;
+              bgfx::UniformHandle      _vh;
+              PixelBuffer              _pixels;
+              clock::time_point        _deadline;
+              bool                     _active;
         
 
         //+    Member Function    +//
@@ -29,6 +57,10 @@ namespace atpt{
         //_ Inner Function
         auto _getWidthFromWindowHandle  (void) -> int;
         auto _getHeightFromWindowHandle (void) -> int;
+        auto _setupView                 (void) -> void;
+        auto _refit                     (void) -> int;
+        auto _look                      (void) -> void;
+        auto _zoomAt                    (double, int, int) -> void;
 
         public:
         //_ Consructor
@@ -40,23 +72,70 @@ namespace atpt{
 
         public:
         //_ Getter
-        auto width  (void) -> int                { return _width; }
-        auto height (void) -> int                { return _height; }
-        auto name   (void) -> const std::string& { return _name; }
-        auto window (void) -> SDL_Window*        { return _wh; }  
+        // width / height はシミュレーションの大きさ (セル). 窓の中に割り当てられた矩形は x / y / viewWidth / viewHeight (画素)
+        auto width      (void) -> int                { return _width; }
+        auto height     (void) -> int                { return _height; }
+        auto name       (void) -> const std::string& { return _name; }
+        auto window     (void) -> SDL_Window*        { return _wh; }  
+        auto active     (void) const -> bool         { return _active; }
+        auto view       (void) const -> bgfx::ViewId { return _view; }
+        auto x          (void) const -> int          { return _x; }
+        auto y          (void) const -> int          { return _y; }
+        auto viewWidth  (void) const -> int          { return _view_width; }
+        auto viewHeight (void) const -> int          { return _view_height; }
+        auto cellSize   (void) const -> int          { return _cell_size; }
+        auto zoom       (void) const -> double       { return _zoom; }
+        auto visible    (void) const -> PixelRect    { return _visible; }
+
+        // 窓のリサイズで bgfx::reset するときのフラグ (既定は BGFX_RESET_VSYNC)
+        static auto resetFlags    (void)     -> uint32_t { return _reset_flags; }
+        static auto setResetFlags (uint32_t) -> void;
         
         //_ Variable Function
+        // step() はシミュレーションスレッド, それ以外は描画 (bgfx の API) スレッドから呼ぶ.
+        // event() / place() / activate() / deactivate() / setCellSize() / setGridSize() の間はシミュレーションを止めておくこと (Simulation::pause).
+        // GPU の資源は activate() で作り deactivate() で手放すので, 表示していないパネルは場所を取らない.
+        // 大きさ (_width, _height) は setGridSize() で決めたもの, 決めていなければ place() で割り当てられた矩形を
+        // 1セル cellSize() 画素で割ったもの. 表示はホイールで拡大縮小, 左ドラッグで移動, HOME で元に戻す
         public:
-        auto draw    (void)             -> int;
-        auto event   (const SDL_Event&) -> int;
-        auto destroy (void)             -> int;
+        auto step        (bool, double = 0.0, int = 1)       -> int;
+        auto draw        (void)                              -> int;
+        auto event       (const SDL_Event&)                  -> int;
+        auto place       (bgfx::ViewId, int, int, int, int)  -> int;
+        auto activate    (void)                              -> int;
+        auto deactivate  (void)                              -> int;
+        auto destroy     (void)                              -> int;
+        auto setCellSize (int)                               -> int;
+        auto setGridSize (int, int)                          -> int;
         
 
         protected:
-        virtual auto _resize  (int, int)         -> int = 0;
-        virtual auto _destroy (void)             -> int = 0;
-        virtual auto _event   (const SDL_Event&) -> int = 0;
-        virtual auto _draw    (void)             -> int = 0;
+        // step() に渡された持ち時間を使い切ったか. 区切って進めるパネルが区切りごとに見る
+        auto _expired (void) const -> bool { return clock::now() >= _deadline; }
+
+        // _visible (見えているセルの範囲) を per_ セルで 1 texel の横幅に直したもの. _present でこの範囲だけを転送する.
+        // _moved は前の draw() から範囲が変わったか (変わっていれば範囲を丸ごと写し直す)
+        auto _visibleTexels (int per_) const -> PixelRect
+        {
+            const int x0 = _visible.x / per_;
+            const int x1 = (_visible.x + _visible.w + per_ - 1) / per_;
+            return PixelRect{ x0, _visible.y, x1 - x0, _visible.h };
+        }
+
+
+        protected:
+        virtual auto _resize     (int, int)         -> int = 0;
+        virtual auto _event      (const SDL_Event&) -> int = 0;
+        // 表示し始めるとき. 今の大きさで GPU の資源を作り, 初めてならシミュレーションの状態も作る
+        virtual auto _activate   (void)             -> int = 0;
+        // 表示をやめるとき. GPU の資源と作り直せるメモリを手放す (シミュレーションの状態は残す)
+        virtual auto _deactivate (void)             -> int = 0;
+        // count_ 世代進める. publish_ のときだけ最後の世代をフレームにして TripleBuffer に出す
+        // (表示が追いつかない世代は色付けも転送もしない). bgfx は呼ばない.
+        // 持ち時間内に終わらなければ yielded を返してよい (続きの呼び出しでは publish_ と count_ は最初のものが効く)
+        virtual auto _step       (bool, int)        -> int = 0;
+        // 最新のフレームのうち見えている範囲を転送してテクスチャを貼る. 拡大と移動は u_view を見てシェーダがする
+        virtual auto _present    (void)             -> int = 0;
     };
 
 }
@@ -1,11 +1,21 @@
 #ifndef ATPT_PANEL_SET_HPP
 #define ATPT_PANEL_SET_HPP
 
+#include <atomic>
 #include <iostream>
+#include <vector>
 #include <panel.hpp>
 
 namespace atpt{
 
+    // パネルの一覧と, Simulation が使う進め方の設定 (世代/秒, 遅れたときに追いつく上限, 1回の step の持ち時間,
+    // 表示しない世代を 1回の step でまとめて進める上限, vsync) を持つ.
+    // + / - で速さを 2倍 / 半分, 0 で「できるだけ速く」, V で vsync を切り替える
+    // GPU の資源を持つのは表示中のパネルだけで, 切り替えると前のパネルは手放し, 次のパネルが (初めてなら状態ごと) 作る.
+    // T で並べて表示 (tiled) に切り替える. tiled では panel_id から順に cols x rows 枚を窓に並べ, それぞれ自分の view に描く.
+    // 表示中のパネルはシミュレーションスレッドから ThreadPool で同時に進め, 描画は全部を積んでから bgfx::frame() を 1回だけ呼ぶ.
+    // キー入力は panel_id のパネル (左上) に, マウスはカーソルの下のパネルに渡す.
+    // セルの大きさ (画素) とシミュレーションの大きさ (0 なら窓に合わせる) は全パネルで揃え, 後から作るパネルにも効かせる
     class PanelSet{
 
         using PanelPtr = std::unique_ptr<Panel>;
@@ -15,6 +25,21 @@ namespace atpt{
                 std::vector<PanelPtr> _panels;
                 size_t                _panel_id;
         mutable SDL_Window*           _wh;
+                double                _rate;
+                int                   _max_backlog;
+                int                   _max_block;
+                double                _step_budget;
+                bool                  _vsync;
+                std::atomic<uint64_t> _presented;
+                bool                  _tiled;
+                int                   _tile_cols;
+                int                   _tile_rows;
+                std::vector<size_t>   _visible;
+                std::vector<int>      _status;
+                int                   _cell_size;
+                int                   _grid_width;
+                int                   _grid_height;
+                bool                  _resize_pending;
 
         public:
         //+    Member Function    +//
@@ -27,17 +52,57 @@ namespace atpt{
         auto panel    (size_t id_) const -> const Panel&       { return *_panels.at(id_); }
         auto panel    (void)       const -> const Panel&       { return *_panels.at(_panel_id); }
         auto window   (void)       const -> const SDL_Window*  { return _wh; }
+
+        // 0 なら表示と関係なくできるだけ速く進める
+        auto rate       (void) const -> double   { return _rate; }
+        auto maxBacklog (void) const -> int      { return _max_backlog; }
+        // 表示しない世代が続くとき, 1回の step() で進めてよい世代数. 大きいほどグリッドをなめる回数が減る
+        auto maxBlock   (void) const -> int      { return _max_block; }
+        // 1回の step() で使ってよい時間 (秒). 大きなグリッドは世代の途中で返し, その間にイベントを通す. 0 なら区切らない
+        auto stepBudget (void) const -> double   { return _step_budget; }
+        auto vsync      (void) const -> bool     { return _vsync; }
+        // draw() した回数. 描画スレッドが増やし, Simulation が読む
+        auto presented  (void) const -> uint64_t { return _presented.load(std::memory_order_acquire); }
+
+        auto tiled   (void) const -> bool                       { return _tiled; }
+        auto visible (void) const -> const std::vector<size_t>& { return _visible; }
+
+        // 窓の大きさが変わって, まだ fitWindow() していないか
+        auto resizePending (void) const -> bool { return _resize_pending; }
+
+        auto cellSize   (void) const -> int { return _cell_size; }
+        auto gridWidth  (void) const -> int { return _grid_width; }
+        auto gridHeight (void) const -> int { return _grid_height; }
         
         //_ Setter
         auto panel     (size_t id_) -> Panel& { return *_panels.at(id_); }
         auto panel     (void)       -> Panel& { return *_panels.at(_panel_id); }
         
+        auto setRate       (double) -> void;
+        auto setMaxBacklog (int)    -> void;
+        auto setMaxBlock   (int)    -> void;
+        auto setStepBudget (double) -> void;
+        auto setVsync      (bool)   -> void;
+        // 以下は表示するパネルを替える. シミュレーションを止めてから描画スレッドで呼ぶこと
+        auto select        (size_t)   -> int;
+        auto setTiled      (bool)     -> int;
+        auto setTiling     (int, int) -> int;
+        auto setCellSize   (int)      -> int;
+        auto setGridSize   (int, int) -> int;
+        auto fitWindow     (void)     -> int;
+
         template <class A, typename... As> inline auto createPanel (As&&...) -> A&;
         
         //_ Variable Function
-        auto draw    (void)             -> int;
-        auto event   (const SDL_Event&) -> int;
-        auto destroy (void)             -> int;
+        auto step    (bool = true, int = 1) -> int;
+        auto draw    (void)                 -> int;
+        auto event   (const SDL_Event&)     -> int;
+        auto destroy (void)                 -> int;
+
+        private:
+        //_ Inner Function
+        auto _layout  (void)     -> int;
+        auto _panelAt (int, int) -> Panel*;
     };
 
         
@@ -52,6 +117,11 @@ namespace atpt{
             std::exit(1);
         }
 
+        // 資源を作るのは表示するパネルだけ. 残りは select() などで表示されたときに作る
+        _panels.back()->setCellSize(_cell_size);
+        _panels.back()->setGridSize(_grid_width, _grid_height);
+        _layout();
+
         return *static_cast<A*>(_panels.back().get());
     }
 }
@@ -0,0 +1,125 @@
+#ifndef ATPT_PIXEL_BUFFER_HPP
+#define ATPT_PIXEL_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // 画素 (テクセル) 単位の矩形
+    struct PixelRect{
+        int x, y, w, h;
+
+        auto operator == (const PixelRect&) const -> bool = default;
+    };
+
+
+    // シミュレーションスレッドが作って描画スレッドへ渡す 1フレーム分の画素.
+    // stamps[ty * タイル列数 + tx] はそのタイル (tile_w x tile_h 画素) が最後に変わった世代. tile_w == 0 なら毎回全面が変わる
+    template <typename P>
+    struct BasicFrame{
+        std::vector<P>        pixels;
+        int                   width      = 0;
+        int                   height     = 0;
+        uint64_t              generation = 0;
+        int                   tile_w     = 0;
+        int                   tile_h     = 0;
+        std::vector<uint64_t> stamps;
+    };
+
+
+    // テクスチャへ転送する画素 (P は BGRA8 なら uint32_t, R8 なら uint8_t) の置き場を複数持ち, bgfx::makeRef でコピーせずに渡す.
+    // 渡した置き場はレンダラが解放コールバックを呼ぶまで使わず, その間は次の置き場に描く.
+    // 各置き場は自分が使われていない間に描き換えられた矩形を覚えておき, acquire() のときに
+    // 直前の置き場からその部分だけを写して追いつく. なのでパネルは変えた部分だけを描けばよい.
+    // 置き場は最初の acquire() まで確保しないので, 使わないパネルはメモリを取らない
+    template <typename P>
+    class BasicPixelBuffer{
+
+        public:
+        using Rect = PixelRect;
+
+        //+   Static Variable    +//
+        // 描き換えた面積が外接矩形のこの割合を超えたら, または矩形がこの数を超えたら外接矩形を1回で転送する
+        static constexpr double full_ratio = 0.5;
+        static constexpr size_t max_rects  = 64;
+
+        private:
+        struct Slot{
+            std::vector<P>        pixels;
+            std::atomic<int>      refs;
+            std::vector<Rect>     stale;
+            bool                  stale_all;
+        };
+
+        //+   Member Variable    +//
+        int                                _width;
+        int                                _height;
+        std::vector<std::unique_ptr<Slot>> _slots;
+        std::vector<std::unique_ptr<Slot>> _retired;
+        Slot*                              _current;
+        std::vector<Rect>                  _dirty;
+        const BasicFrame<P>*               _lent;
+        uint64_t                           _lent_generation;
+
+        //+   Static Function    +//
+        static inline void _release (void*, void*);
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        inline BasicPixelBuffer (int, int);
+
+        BasicPixelBuffer (const BasicPixelBuffer&)             = delete;
+        BasicPixelBuffer& operator = (const BasicPixelBuffer&) = delete;
+
+        private:
+        //_ Inner Function
+        inline auto _makeSlot   (void)                             -> std::unique_ptr<Slot>;
+        inline auto _fit        (Slot&)                            -> void;
+        inline auto _catchUp    (Slot&, const Slot&)               -> void;
+        inline auto _markStale  (const Rect&)                      -> void;
+        inline auto _uploadRect (bgfx::TextureHandle, const Rect&) -> void;
+
+        public:
+        //_ Constant Getter
+        auto width  (void) const -> int    { return _width; }
+        auto height (void) const -> int    { return _height; }
+        auto slots  (void) const -> size_t { return _slots.size(); }
+
+        //_ Getter
+        auto data (void)   -> P* { return _current->pixels.data(); }
+        auto row  (int y_) -> P* { return data() + static_cast<size_t>(y_) * _width; }
+
+        //_ Variable Function
+        // keep_ = false なら全面を描き直す前提で, 古い部分を写す手間を省く
+        inline auto acquire (bool = true)         -> P*;
+        inline auto dirty   (int, int, int, int)  -> void;
+        inline auto flush   (bgfx::TextureHandle) -> void;
+        inline auto upload  (bgfx::TextureHandle) -> void;
+        inline auto resize  (int, int)            -> int;
+        // 置き場を手放す (大きさは残す). レンダラが使っている置き場は返ってくるまで預かる
+        inline auto release (void)                -> void;
+
+        // since_ 世代を表示済みとして, それより後に変わったタイルのうち clip_ (見えている範囲) にかかる部分だけを frame_ から写して転送する.
+        // clip_ の外は古いままなので, clip_ を変えたら since_ = 0 で写し直すこと.
+        // 大きさが合わない (リサイズ直後の) フレームは捨てて false を返す.
+        // tile_w == 0 のフレームは写さずに置き場と画素を入れ替えるので, frame_ には古い画素が残る (書き手は全面を書き直すこと)
+        inline auto uploadFrame (BasicFrame<P>&, uint64_t since_, bgfx::TextureHandle, const Rect& clip_) -> bool;
+        inline auto uploadFrame (BasicFrame<P>&, uint64_t since_, bgfx::TextureHandle)                   -> bool;
+    };
+
+
+    using PixelBuffer = BasicPixelBuffer<uint32_t>;
+    using StateBuffer = BasicPixelBuffer<uint8_t>;
+    using PixelFrame  = BasicFrame<uint32_t>;
+    using StateFrame  = BasicFrame<uint8_t>;
+}
+
+#include "pixel_buffer.inl"
+
+#endif
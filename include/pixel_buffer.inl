@@ -0,0 +1,342 @@
+#ifndef ATPT_PIXEL_BUFFER_INL
+#define ATPT_PIXEL_BUFFER_INL
+
+#include "pixel_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace atpt{
+
+    //+   Static Function    +//
+    // レンダラがメモリを使い終えたときに (レンダースレッドから) 呼ばれる
+    template <typename P>
+    void BasicPixelBuffer<P>::_release (void*, void* user_)
+    {
+        static_cast<Slot*>(user_)->refs.fetch_sub(1, std::memory_order_release);
+    }
+
+
+    //+   Member Function    +//
+    //_ Constructor
+    template <typename P>
+    BasicPixelBuffer<P>::BasicPixelBuffer (int width_, int height_)
+        : _width           { width_ }
+        , _height          { height_ }
+        , _slots           ( )
+        , _retired         ( )
+        , _current         { nullptr }
+        , _dirty           ( )
+        , _lent            { nullptr }
+        , _lent_generation { 0 }
+    {
+        return;
+    }
+
+
+    //_ Inner Function
+    template <typename P>
+    auto BasicPixelBuffer<P>::_makeSlot (void)
+        -> std::unique_ptr<typename BasicPixelBuffer<P>::Slot>
+    {
+        std::unique_ptr<Slot> s = std::make_unique<Slot>();
+        s->refs.store(0);
+        _fit(*s);
+        return s;
+    }
+
+
+    // 置き場を今の大きさにして空にする. 確保済みの中に収まれば取り直さない
+    template <typename P>
+    auto BasicPixelBuffer<P>::_fit (Slot& slot_)
+        -> void
+    {
+        const size_t n = static_cast<size_t>(_width) * _height;
+        if (n > slot_.pixels.capacity()) slot_.pixels.reserve(n + n / 2);
+        slot_.pixels.assign(n, 0);
+        slot_.stale.clear();
+        slot_.stale_all = false;
+    }
+
+
+    // from_ は最新の絵なので, dst_ の古い部分をそこから写す. from_ がレンダラに渡っていても読むだけなので構わない
+    template <typename P>
+    auto BasicPixelBuffer<P>::_catchUp (Slot& dst_, const Slot& from_)
+        -> void
+    {
+        if (dst_.stale_all) {
+            std::copy(from_.pixels.begin(), from_.pixels.end(), dst_.pixels.begin());
+        }else{
+            for(const Rect& r : dst_.stale){
+                for(int b = r.y; b < r.y + r.h; ++b){
+                    const size_t o = static_cast<size_t>(b) * _width + r.x;
+                    std::memcpy(dst_.pixels.data() + o, from_.pixels.data() + o, static_cast<size_t>(r.w) * sizeof(P));
+                }
+            }
+        }
+        dst_.stale.clear();
+        dst_.stale_all = false;
+    }
+
+
+    // 今の置き場以外は r_ の部分が古くなる
+    template <typename P>
+    auto BasicPixelBuffer<P>::_markStale (const Rect& r_)
+        -> void
+    {
+        const bool all = r_.w == _width and r_.h == _height;
+
+        for(const std::unique_ptr<Slot>& s : _slots){
+            if (s.get() == _current or s->stale_all) continue;
+            if (all or s->stale.size() >= max_rects) {
+                s->stale.clear();
+                s->stale_all = true;
+            }else{
+                s->stale.push_back(r_);
+            }
+        }
+    }
+
+
+    // 行の間隔は width * sizeof(P) バイトのまま, 矩形の先頭から参照で渡す
+    template <typename P>
+    auto BasicPixelBuffer<P>::_uploadRect (bgfx::TextureHandle th_, const Rect& r_)
+        -> void
+    {
+        const size_t   offset = static_cast<size_t>(r_.y) * _width + r_.x;
+        const uint32_t bytes  = static_cast<uint32_t>((static_cast<size_t>(r_.h - 1) * _width + r_.w) * sizeof(P));
+
+        _current->refs.fetch_add(1, std::memory_order_relaxed);
+        const bgfx::Memory* mem = bgfx::makeRef(_current->pixels.data() + offset, bytes, _release, _current);
+        bgfx::updateTexture2D(
+            th_, 0, 0,
+            static_cast<uint16_t>(r_.x), static_cast<uint16_t>(r_.y), static_cast<uint16_t>(r_.w), static_cast<uint16_t>(r_.h),
+            mem, static_cast<uint16_t>(_width * sizeof(P))
+        );
+    }
+
+
+    //_ Variable Function
+    // レンダラが手放している置き場を返す. 全部使用中なら置き場を1つ増やす (描画を止めない).
+    // レンダラの遅れが 1-2 フレームなら置き場は 2-3 個で落ち着く.
+    // resize() のときに使用中だった置き場は, 返ってきたら大きさを合わせて使い回す
+    template <typename P>
+    auto BasicPixelBuffer<P>::acquire (bool keep_)
+        -> P*
+    {
+        for(std::unique_ptr<Slot>& s : _retired){
+            if (s->refs.load(std::memory_order_acquire) != 0) continue;
+            _fit(*s);
+            s->stale_all = _current != nullptr;
+            _slots.push_back(std::move(s));
+        }
+        _retired.erase(std::remove(_retired.begin(), _retired.end(), nullptr), _retired.end());
+        _dirty.clear();
+        _lent = nullptr;
+
+        Slot* const prev = _current;
+        Slot*       next = nullptr;
+        for(const std::unique_ptr<Slot>& s : _slots){
+            if (s->refs.load(std::memory_order_acquire) == 0) { next = s.get(); break; }
+        }
+        if (not next) {
+            _slots.push_back(_makeSlot());
+            next            = _slots.back().get();
+            next->stale_all = prev != nullptr;
+        }
+
+        if (keep_ and prev) _catchUp(*next, *prev);
+        else                { next->stale.clear(); next->stale_all = false; }
+
+        _current = next;
+        return data();
+    }
+
+
+    // 今のフレームで描き換えた矩形を積む. 画面の外は切り落とす
+    template <typename P>
+    auto BasicPixelBuffer<P>::dirty (int x_, int y_, int w_, int h_)
+        -> void
+    {
+        const int x0 = std::max(x_, 0);
+        const int y0 = std::max(y_, 0);
+        const int x1 = std::min(x_ + w_, _width);
+        const int y1 = std::min(y_ + h_, _height);
+        if (x0 < x1 and y0 < y1) _dirty.push_back(Rect{ x0, y0, x1 - x0, y1 - y0 });
+    }
+
+
+    // 積んだ矩形を縦に, 次に横に隣り合うものどうしでまとめて転送する. 隙間が少なければ外接矩形を1回で送る
+    template <typename P>
+    auto BasicPixelBuffer<P>::flush (bgfx::TextureHandle th_)
+        -> void
+    {
+        if (_dirty.empty()) return;
+
+        std::vector<Rect>& rs = _dirty;
+
+        std::sort(rs.begin(), rs.end(), [](const Rect& a_, const Rect& b_){
+            return a_.x != b_.x ? a_.x < b_.x : a_.w != b_.w ? a_.w < b_.w : a_.y < b_.y;
+        });
+        size_t n = 0;
+        for(size_t i = 1; i < rs.size(); ++i){
+            Rect& m = rs[n];
+            if (rs[i].x == m.x and rs[i].w == m.w and rs[i].y <= m.y + m.h) m.h = std::max(m.y + m.h, rs[i].y + rs[i].h) - m.y;
+            else                                                               rs[++n] = rs[i];
+        }
+        rs.resize(n + 1);
+
+        std::sort(rs.begin(), rs.end(), [](const Rect& a_, const Rect& b_){
+            return a_.y != b_.y ? a_.y < b_.y : a_.h != b_.h ? a_.h < b_.h : a_.x < b_.x;
+        });
+        n = 0;
+        for(size_t i = 1; i < rs.size(); ++i){
+            Rect& m = rs[n];
+            if (rs[i].y == m.y and rs[i].h == m.h and rs[i].x <= m.x + m.w) m.w = std::max(m.x + m.w, rs[i].x + rs[i].w) - m.x;
+            else                                                               rs[++n] = rs[i];
+        }
+        rs.resize(n + 1);
+
+        size_t area = 0;
+        Rect   box  = rs.front();
+        for(const Rect& r : rs){
+            area += static_cast<size_t>(r.w) * r.h;
+            const int x1 = std::max(box.x + box.w, r.x + r.w);
+            const int y1 = std::max(box.y + box.h, r.y + r.h);
+            box.x = std::min(box.x, r.x);
+            box.y = std::min(box.y, r.y);
+            box.w = x1 - box.x;
+            box.h = y1 - box.y;
+        }
+
+        if (rs.size() > max_rects or static_cast<double>(area) > full_ratio * box.w * box.h) rs.assign(1, box);
+
+        for(const Rect& r : rs){
+            _uploadRect(th_, r);
+            _markStale(r);
+        }
+        _dirty.clear();
+    }
+
+
+    // 全面を転送する
+    template <typename P>
+    auto BasicPixelBuffer<P>::upload (bgfx::TextureHandle th_)
+        -> void
+    {
+        if (_width <= 0 or _height <= 0) return;
+
+        const Rect all{ 0, 0, _width, _height };
+        _uploadRect(th_, all);
+        _markStale(all);
+        _dirty.clear();
+    }
+
+
+    // 空いている置き場はその場で大きさを変える. 使用中の置き場はレンダラが手放すまで _retired に預ける
+    // (代わりは作らず, 返ってきたら acquire() が使い回す)
+    template <typename P>
+    auto BasicPixelBuffer<P>::resize (int width_, int height_)
+        -> int
+    {
+        _width  = width_;
+        _height = height_;
+
+        for(std::unique_ptr<Slot>& s : _slots){
+            if (s->refs.load(std::memory_order_acquire) != 0) _retired.push_back(std::move(s));
+            else                                               _fit(*s);
+        }
+        _slots.erase(std::remove(_slots.begin(), _slots.end(), nullptr), _slots.end());
+        _current = _slots.empty() ? nullptr : _slots.front().get();
+        _dirty.clear();
+        _lent    = nullptr;
+
+        return 0;
+    }
+
+
+    template <typename P>
+    auto BasicPixelBuffer<P>::release (void)
+        -> void
+    {
+        _retired.erase(
+            std::remove_if(_retired.begin(), _retired.end(), [](const std::unique_ptr<Slot>& s_){ return s_->refs.load(std::memory_order_acquire) == 0; }),
+            _retired.end()
+        );
+        for(std::unique_ptr<Slot>& s : _slots){
+            if (s->refs.load(std::memory_order_acquire) != 0) _retired.push_back(std::move(s));
+        }
+        _slots.clear();
+        _slots.shrink_to_fit();
+        _current = nullptr;
+        _dirty.clear();
+        _lent    = nullptr;
+    }
+
+
+    template <typename P>
+    auto BasicPixelBuffer<P>::uploadFrame (BasicFrame<P>& frame_, uint64_t since_, bgfx::TextureHandle th_, const Rect& clip_)
+        -> bool
+    {
+        if (frame_.generation == 0 or frame_.width != _width or frame_.height != _height) return false;
+
+        const int cx0 = std::max(clip_.x, 0);
+        const int cy0 = std::max(clip_.y, 0);
+        const int cx1 = std::min(clip_.x + clip_.w, _width);
+        const int cy1 = std::min(clip_.y + clip_.h, _height);
+        if (cx0 >= cx1 or cy0 >= cy1) return true;
+
+        // 毎回全面が変わるフレームは写さない. 空いた置き場と画素の vector を入れ替えてそのまま参照で渡すので,
+        // 渡した画素はレンダラが手放すまで置き場が預かり, 三重バッファには戻らない.
+        // 同じフレームを (見える範囲を変えて) もう一度送るときは, 今の置き場に入っている画素から送る
+        if (frame_.tile_w == 0) {
+            if (&frame_ != _lent or frame_.generation != _lent_generation) {
+                acquire(false);
+                _current->pixels.swap(frame_.pixels);
+                _lent            = &frame_;
+                _lent_generation = frame_.generation;
+            }
+            dirty(cx0, cy0, cx1 - cx0, cy1 - cy0);
+            flush(th_);
+            return true;
+        }
+
+        // 見えている範囲を丸ごと写す. 範囲の外は転送しないので古いまま
+        if (since_ == 0 or since_ > frame_.generation) {
+            acquire(false);
+            for(int b = cy0; b < cy1; ++b){
+                std::memcpy(row(b) + cx0, frame_.pixels.data() + static_cast<size_t>(b) * _width + cx0, static_cast<size_t>(cx1 - cx0) * sizeof(P));
+            }
+            dirty(cx0, cy0, cx1 - cx0, cy1 - cy0);
+            flush(th_);
+            return true;
+        }
+
+        acquire(true);
+        const int tiles_x = (_width + frame_.tile_w - 1) / frame_.tile_w;
+        for(size_t t = 0; t < frame_.stamps.size(); ++t){
+            if (frame_.stamps[t] <= since_) continue;
+
+            const int x0 = std::max(static_cast<int>(t % tiles_x) * frame_.tile_w, cx0);
+            const int y0 = std::max(static_cast<int>(t / tiles_x) * frame_.tile_h, cy0);
+            const int x1 = std::min(static_cast<int>(t % tiles_x) * frame_.tile_w + frame_.tile_w, cx1);
+            const int y1 = std::min(static_cast<int>(t / tiles_x) * frame_.tile_h + frame_.tile_h, cy1);
+            if (x0 >= x1 or y0 >= y1) continue;
+
+            for(int b = y0; b < y1; ++b){
+                std::memcpy(row(b) + x0, frame_.pixels.data() + static_cast<size_t>(b) * _width + x0, static_cast<size_t>(x1 - x0) * sizeof(P));
+            }
+            dirty(x0, y0, x1 - x0, y1 - y0);
+        }
+        flush(th_);
+        return true;
+    }
+
+
+    template <typename P>
+    auto BasicPixelBuffer<P>::uploadFrame (BasicFrame<P>& frame_, uint64_t since_, bgfx::TextureHandle th_)
+        -> bool
+    {
+        return uploadFrame(frame_, since_, th_, Rect{ 0, 0, _width, _height });
+    }
+}
+#endif
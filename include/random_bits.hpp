@@ -0,0 +1,92 @@
+#ifndef ATPT_RANDOM_BITS_HPP
+#define ATPT_RANDOM_BITS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+namespace atpt{
+
+    // 乱数ビットをワード単位でまとめて埋める. 1ワード = 64セル (ビットグリッドや詰めた状態テクスチャと同じ並び).
+    // 書き出し先は void* で受け, memcpy 相当で書くので uint8_t の置き場にもそのまま書ける
+    enum class RandomEngine{
+        MT19937,    // std::mt19937. 出力が規格で決まっているので再現用
+        Xoshiro,    // xoshiro256++ x4 レーン. AVX2 なら 4レーンを1命令列で回す
+    };
+
+
+    // xoshiro256++ を 4本並べたもの. out[4j + l] がレーン l の j番目の出力なので,
+    // SIMD でもスカラでも同じ列になる. レーンどうしは 2^128 ステップずつ離してある
+    class Xoshiro256x4{
+
+        //+   Member Variable    +//
+        alignas(32) uint64_t _s[4][4];    // _s[k][lane]
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        explicit Xoshiro256x4 (uint64_t);
+
+        //_ Variable Function
+        auto seed (uint64_t)           -> void;
+        auto fill (void*, size_t)      -> void;
+
+        private:
+        //_ Inner Function
+        auto _fillScalar (unsigned char*, size_t) -> void;
+        auto _fillAVX2   (unsigned char*, size_t) -> void;
+    };
+
+
+    // mt19937 の 32bit を 2つ合わせて 1ワードにする (捨てるビットはない)
+    auto fillRandom (std::mt19937&, void*, size_t) -> void;
+    auto fillRandom (Xoshiro256x4&, void*, size_t) -> void;
+
+    auto randomEngineName (RandomEngine) -> const char*;
+
+
+    class PeriodicBoundaryBitGrid;
+
+    // Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+    // 128bit のカウンタと 64bit の鍵から 128bit を返す純粋関数なので, どのセルの乱数もほかと無関係に,
+    // どの順番でもどのスレッドでも同じ値で計算できる
+    constexpr auto philox4x32 (std::array<uint32_t, 4> ctr_, uint64_t key_)
+        -> std::array<uint32_t, 4>
+    {
+        uint32_t k0 = static_cast<uint32_t>(key_);
+        uint32_t k1 = static_cast<uint32_t>(key_ >> 32);
+        for(int r = 0; r < 10; ++r){
+            const uint64_t p0 = uint64_t{0xD2511F53u} * ctr_[0];
+            const uint64_t p1 = uint64_t{0xCD9E8D57u} * ctr_[2];
+            ctr_ = {
+                static_cast<uint32_t>(p1 >> 32) ^ ctr_[1] ^ k0, static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ ctr_[3] ^ k1, static_cast<uint32_t>(p0),
+            };
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        return ctr_;
+    }
+
+    // (seed_, generation_, index_) で決まる 64bit. 1ブロック (128bit) を偶数・奇数の index_ で分け合う
+    constexpr auto counterRandom (uint64_t seed_, uint64_t generation_, uint64_t index_)
+        -> uint64_t
+    {
+        const uint64_t                block = index_ >> 1;
+        const std::array<uint32_t, 4> r     = philox4x32({
+            static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+            static_cast<uint32_t>(generation_), static_cast<uint32_t>(generation_ >> 32),
+        }, seed_);
+        return (index_ & 1) ? (r[2] | (static_cast<uint64_t>(r[3]) << 32)) : (r[0] | (static_cast<uint64_t>(r[1]) << 32));
+    }
+
+    // counterRandom(seed_, generation_, index_ + j) を j = [0, n_) について並べる. AVX2 では 4ブロックずつ計算する
+    auto fillCounterRandom (uint64_t seed_, uint64_t generation_, uint64_t index_, void*, size_t n_) -> void;
+
+    // 行 b のワード i に counterRandom(seed_, generation_, b * words + i) を入れ (各セル 1/2 で生), ハローまで埋める.
+    // 行の帯ごとに並列に埋めるが, 結果はスレッド数によらない
+    auto randomizeGrid (PeriodicBoundaryBitGrid&, uint64_t seed_, uint64_t generation_ = 0) -> void;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef ATPT_SHADER_CACHE_HPP
+#define ATPT_SHADER_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // 実行ファイルに埋め込んだコンパイル済みシェーダ 1つ分 (CMake の ATPT_EMBED_SHADERS で生成される).
+    // name はパスの stem ("vs_fullscreen" など)
+    struct EmbeddedShader{
+        const char*              name;
+        bgfx::RendererType::Enum renderer;
+        const uint8_t*           data;
+        uint32_t                 size;
+    };
+
+    // 生成された embedded_shaders.cpp が定義する. 埋め込まないビルドでは空 (count_ = 0)
+    auto embeddedShaders (size_t& count_) -> const EmbeddedShader*;
+
+
+    // シェーダとプログラムをプロセスで 1つずつだけ作って使い回す. キーは (レンダラの種類, パス).
+    // 埋め込んだものがあればそれを, なければファイルを読む. bgfx と同じく描画スレッドからだけ使う.
+    // 作ったものは clear() (bgfx::shutdown の前) まで持ち続けるので, 呼び手は destroy しない
+    class ShaderCache{
+
+        using Key = std::pair<bgfx::RendererType::Enum, std::string>;
+
+        //+   Member Variable    +//
+        std::map<Key, bgfx::ShaderHandle>                  _shaders;
+        std::map<std::pair<Key, Key>, bgfx::ProgramHandle> _programs;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        ShaderCache (void) = default;
+
+        ShaderCache (const ShaderCache&)             = delete;
+        ShaderCache& operator = (const ShaderCache&) = delete;
+
+        //_ Static Function
+        static auto shared (void) -> ShaderCache&;
+
+        //_ Variable Function
+        auto shader  (const std::filesystem::path&)                               -> bgfx::ShaderHandle;
+        auto program (const std::filesystem::path&, const std::filesystem::path&) -> bgfx::ProgramHandle;
+        auto clear   (void)                                                       -> void;
+
+        private:
+        //_ Inner Function
+        auto _load (const std::filesystem::path&) -> const bgfx::Memory*;
+    };
+}
+
+#endif
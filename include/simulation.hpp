@@ -0,0 +1,46 @@
+#ifndef ATPT_SIMULATION_HPP
+#define ATPT_SIMULATION_HPP
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace atpt{
+
+    class PanelSet;
+
+    // 表示中のパネルの step() を専用スレッドで回し続ける. フレームは各パネルの TripleBuffer で描画スレッドへ渡るので,
+    // シミュレーションは vsync や GPU を待たず, 描画は常に最新の完成したフレームを出す.
+    // 進める速さと追いつき方は PanelSet の rate() / maxBacklog() に従う
+    class Simulation{
+
+        //+   Member Variable    +//
+        PanelSet&         _panels;
+        std::mutex        _mutex;
+        std::atomic<int>  _waiting;
+        std::atomic<bool> _running;
+        std::thread       _thread;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        explicit Simulation (PanelSet&);
+
+        Simulation (const Simulation&)             = delete;
+        Simulation& operator = (const Simulation&) = delete;
+
+        //_ Destructor
+        ~Simulation ();
+
+        //_ Variable Function
+        // 返したロックを持っている間はステップしない (イベント処理やリサイズで使う)
+        auto pause (void) -> std::unique_lock<std::mutex>;
+        auto stop  (void) -> void;
+
+        private:
+        //_ Inner Function
+        auto _run (void) -> void;
+    };
+}
+
+#endif
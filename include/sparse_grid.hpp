@@ -0,0 +1,91 @@
+#ifndef ATPT_SPARSE_GRID_HPP
+#define ATPT_SPARSE_GRID_HPP
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace atpt{
+
+    // 境界のないグリッド. 2^C x 2^C セルのチャンクを必要になったときだけ確保し,
+    // チャンク座標をキーにしたオープンアドレス法 (線形探索) のハッシュ表で引く.
+    // 確保されていないセルは既定値として読める. collect() で既定値だけになったチャンクを解放する.
+    // 書き込みでチャンクが増えても他のチャンクは動かないので, 取得済みのポインタは collect() まで有効
+    template <typename T, int C = 5>
+    class SparseGrid{
+
+        public:
+        //+   Static Variable    +//
+        static constexpr int chunk_log  = C;
+        static constexpr int chunk_size = 1 << C;
+        static constexpr int chunk_area = chunk_size * chunk_size;
+
+        private:
+        struct Slot{
+            uint64_t key;
+            uint32_t chunk;
+        };
+
+        struct Chunk{
+            int                  cx, cy;
+            std::unique_ptr<T[]> cells;
+        };
+
+        static constexpr uint32_t _empty = ~uint32_t{0};
+
+        //+   Member Variable    +//
+              std::vector<Slot>     _table;
+              std::vector<Chunk>    _chunks;
+              std::vector<uint32_t> _free;
+              size_t                _count;
+        const T                     _default_value;
+
+        //+   Static Function    +//
+        static auto _key  (int cx_, int cy_) -> uint64_t { return (static_cast<uint64_t>(static_cast<uint32_t>(cx_)) << 32) | static_cast<uint32_t>(cy_); }
+        static auto _cell (int x_, int y_)   -> size_t   { return static_cast<size_t>(y_ & (chunk_size - 1)) * chunk_size + (x_ & (chunk_size - 1)); }
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        inline explicit SparseGrid (const T&, size_t = 64);
+
+        private:
+        //_ Constant Function
+        inline auto _home (uint64_t) const -> size_t;
+        inline auto _find (int, int) const -> T*;
+
+        //_ Inner Function
+        inline auto _insert (int, int)   -> T*;
+        inline auto _erase  (size_t)     -> void;
+        inline auto _grow   (void)       -> void;
+
+        public:
+        //_ Constant Getter
+        inline auto operator () (int, int) const -> const T&;
+        inline auto neumann     (int, int) const -> std::array<const T*, 5>;
+        inline auto moore       (int, int) const -> std::array<const T*, 9>;
+        inline auto chunk       (int, int) const -> const T*;
+
+        auto chunkCount   (void) const -> size_t   { return _count; }
+        auto defaultValue (void) const -> const T& { return _default_value; }
+
+        // 確保済みの各チャンクについて f_(cx, cy, cells) を呼ぶ. cells[y * chunk_size + x]
+        template <typename F> inline auto forEachChunk (F&&) const -> void;
+
+        public:
+        //_ Getter
+        inline auto operator () (int, int) -> T&;
+
+        public:
+        //_ Variable Function
+        inline auto set     (int, int, const T&) -> void;
+        inline auto collect (void)               -> size_t;
+        inline auto clear   (void)               -> void;
+    };
+}
+
+#include "sparse_grid.inl"
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef ATPT_SPARSE_GRID_INL
+#define ATPT_SPARSE_GRID_INL
+
+#include "sparse_grid.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace atpt{
+
+    // capacity_ はハッシュ表の初期の大きさ (2 のべき乗に切り上げる)
+    template <typename T, int C>
+    SparseGrid<T, C>::SparseGrid (const T& dv_, size_t capacity_)
+        : _table         ( std::max<size_t>(std::bit_ceil(capacity_), 8), Slot{ 0, _empty } )
+        , _chunks        ( )
+        , _free          ( )
+        , _count         { 0 }
+        , _default_value ( dv_ )
+    {
+        return;
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::_home (uint64_t key_) const
+        -> size_t
+    {
+        return static_cast<size_t>((key_ * 0x9E3779B97F4A7C15ull) >> 32) & (_table.size() - 1);
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::_find (int cx_, int cy_) const
+        -> T*
+    {
+        const uint64_t key  = _key(cx_, cy_);
+        const size_t   mask = _table.size() - 1;
+
+        for(size_t i = _home(key); _table[i].chunk != _empty; i = (i + 1) & mask){
+            if (_table[i].key == key) return _chunks[_table[i].chunk].cells.get();
+        }
+        return nullptr;
+    }
+
+
+    // 無ければ既定値で埋めたチャンクを作る
+    template <typename T, int C>
+    auto SparseGrid<T, C>::_insert (int cx_, int cy_)
+        -> T*
+    {
+        const uint64_t key = _key(cx_, cy_);
+
+        size_t i = _home(key);
+        for(; _table[i].chunk != _empty; i = (i + 1) & (_table.size() - 1)){
+            if (_table[i].key == key) return _chunks[_table[i].chunk].cells.get();
+        }
+
+        uint32_t id;
+        if (_free.empty()) {
+            id = static_cast<uint32_t>(_chunks.size());
+            _chunks.push_back(Chunk{ cx_, cy_, nullptr });
+        }else{
+            id = _free.back();
+            _free.pop_back();
+            _chunks[id].cx = cx_;
+            _chunks[id].cy = cy_;
+        }
+        _chunks[id].cells = std::make_unique<T[]>(chunk_area);
+        std::fill(_chunks[id].cells.get(), _chunks[id].cells.get() + chunk_area, _default_value);
+
+        _table[i] = Slot{ key, id };
+        ++_count;
+
+        // 負荷率 1/2 を超えたら広げる
+        if (_count * 2 > _table.size()) _grow();
+
+        return _chunks[id].cells.get();
+    }
+
+
+    // スロット i_ を空け, 後ろに続くクラスタを詰め直す (墓標を残さない削除)
+    template <typename T, int C>
+    auto SparseGrid<T, C>::_erase (size_t i_)
+        -> void
+    {
+        const size_t mask = _table.size() - 1;
+
+        const uint32_t id = _table[i_].chunk;
+        _chunks[id].cells.reset();
+        _free.push_back(id);
+        --_count;
+
+        size_t hole = i_;
+        for(size_t j = (i_ + 1) & mask; _table[j].chunk != _empty; j = (j + 1) & mask){
+            const size_t home = _home(_table[j].key);
+            // home が (hole, j] の外にあれば hole へ動かしても探索の列は切れない
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                _table[hole] = _table[j];
+                hole = j;
+            }
+        }
+        _table[hole] = Slot{ 0, _empty };
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::_grow (void)
+        -> void
+    {
+        std::vector<Slot> old(_table.size() * 2, Slot{ 0, _empty });
+        old.swap(_table);
+
+        const size_t mask = _table.size() - 1;
+        for(const Slot& s : old){
+            if (s.chunk == _empty) continue;
+            size_t i = _home(s.key);
+            while (_table[i].chunk != _empty) i = (i + 1) & mask;
+            _table[i] = s;
+        }
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::operator () (int x_, int y_) const
+        -> const T&
+    {
+        const T* c = _find(x_ >> C, y_ >> C);
+        return c ? c[_cell(x_, y_)] : _default_value;
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::neumann (int x_, int y_) const
+        -> std::array<const T*, 5>
+    {
+        return { &(*this)(x_, y_ - 1), &(*this)(x_ - 1, y_), &(*this)(x_, y_), &(*this)(x_ + 1, y_), &(*this)(x_, y_ + 1) };
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::moore (int x_, int y_) const
+        -> std::array<const T*, 9>
+    {
+        const int lx = x_ & (chunk_size - 1);
+        const int ly = y_ & (chunk_size - 1);
+
+        // チャンクの内側なら 1回引くだけで済む
+        if (lx > 0 and lx < chunk_size - 1 and ly > 0 and ly < chunk_size - 1) {
+            const T* c = _find(x_ >> C, y_ >> C);
+            if (not c) {
+                const T* d = &_default_value;
+                return { d, d, d, d, d, d, d, d, d };
+            }
+            c += _cell(x_, y_);
+            const int s = chunk_size;
+            return { c - s - 1, c - s, c - s + 1,
+                     c     - 1, c,     c     + 1,
+                     c + s - 1, c + s, c + s + 1 };
+        }
+
+        std::array<const T*, 9> out{};
+        for(int dy = -1, k = 0; dy <= 1; ++dy){
+            for(int dx = -1; dx <= 1; ++dx, ++k){
+                out[k] = &(*this)(x_ + dx, y_ + dy);
+            }
+        }
+        return out;
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::chunk (int cx_, int cy_) const
+        -> const T*
+    {
+        return _find(cx_, cy_);
+    }
+
+
+    template <typename T, int C> template <typename F>
+    auto SparseGrid<T, C>::forEachChunk (F&& f_) const
+        -> void
+    {
+        for(const Chunk& c : _chunks){
+            if (c.cells) f_(c.cx, c.cy, static_cast<const T*>(c.cells.get()));
+        }
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::operator () (int x_, int y_)
+        -> T&
+    {
+        return _insert(x_ >> C, y_ >> C)[_cell(x_, y_)];
+    }
+
+
+    // 既定値を書くだけならチャンクを作らない
+    template <typename T, int C>
+    auto SparseGrid<T, C>::set (int x_, int y_, const T& v_)
+        -> void
+    {
+        if (v_ == _default_value) {
+            T* c = _find(x_ >> C, y_ >> C);
+            if (c) c[_cell(x_, y_)] = v_;
+        }else{
+            (*this)(x_, y_) = v_;
+        }
+    }
+
+
+    // 既定値だけになったチャンクを解放し, その数を返す
+    template <typename T, int C>
+    auto SparseGrid<T, C>::collect (void)
+        -> size_t
+    {
+        size_t freed = 0;
+
+        for(size_t i = 0; i < _table.size(); ){
+            if (_table[i].chunk == _empty) { ++i; continue; }
+
+            const T* cells = _chunks[_table[i].chunk].cells.get();
+            const bool empty = std::all_of(cells, cells + chunk_area, [&](const T& v_){ return v_ == _default_value; });
+            if (not empty) { ++i; continue; }
+
+            // 詰め直しで i に別のスロットが来るかもしれないので i は進めない
+            _erase(i);
+            ++freed;
+        }
+
+        return freed;
+    }
+
+
+    template <typename T, int C>
+    auto SparseGrid<T, C>::clear (void)
+        -> void
+    {
+        std::fill(_table.begin(), _table.end(), Slot{ 0, _empty });
+        _chunks.clear();
+        _free.clear();
+        _count = 0;
+    }
+}
+#endif
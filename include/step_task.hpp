@@ -0,0 +1,55 @@
+#ifndef ATPT_STEP_TASK_HPP
+#define ATPT_STEP_TASK_HPP
+
+#include <coroutine>
+#include <exception>
+#include <variant>
+
+namespace atpt{
+
+    // 1世代の計算を途中で止めて続きから再開できるコルーチン. 本体は co_yield {} で区切りごとに手を離し,
+    // 呼び手は resume() を繰り返して co_return まで進める. 作った直後は何もしていない
+    class StepTask{
+
+        public:
+        struct promise_type{
+            auto get_return_object   (void)           -> StepTask            { return StepTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            auto initial_suspend     (void)           -> std::suspend_always { return { }; }
+            auto final_suspend       (void) noexcept  -> std::suspend_always { return { }; }
+            auto yield_value         (std::monostate) -> std::suspend_always { return { }; }
+            auto return_void         (void)           -> void                { return; }
+            auto unhandled_exception (void)           -> void                { std::terminate(); }
+        };
+
+        private:
+        //+   Member Variable    +//
+        std::coroutine_handle<promise_type> _h;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        StepTask (void) : _h { } { return; }
+        explicit StepTask (std::coroutine_handle<promise_type> h_) : _h { h_ } { return; }
+
+        StepTask (StepTask&&) noexcept;
+        StepTask& operator = (StepTask&&) noexcept;
+
+        StepTask (const StepTask&)             = delete;
+        StepTask& operator = (const StepTask&) = delete;
+
+        //_ Destructor
+        ~StepTask ();
+
+        //_ Constant Getter
+        // 再開できる (始まっていて終わっていない) か
+        auto pending (void) const -> bool { return _h and not _h.done(); }
+
+        //_ Variable Function
+        // 次の区切りまで進める. 最後まで終わったら true
+        auto resume (void) -> bool;
+        // 途中でも捨てる (局所変数は破棄される)
+        auto reset  (void) -> void;
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef ATPT_TEXTURE_HPP
+#define ATPT_TEXTURE_HPP
+
+#include <cstdint>
+#include <bgfx/bgfx.h>
+
+namespace atpt{
+
+    // 中身を描き換え続ける 2D テクスチャ. 大きさは切り上げて余裕を持って確保し, 使う大きさ (texel (0, 0) から width x height) が
+    // その中に収まる間は作り直さない. 転送は部分更新だけなので, 窓のドラッグで destroy / create が続かない.
+    // シェーダには u_texsize (xy: 確保した大きさ, zw: 使っている大きさ) を渡す. Palette と同じく最初の handle() / bind() まで作らない
+    class Texture{
+
+        //+   Static Variable    +//
+        static constexpr int align    = 64;
+        static constexpr int max_size = 16384;
+
+        //+   Member Variable    +//
+        const char*               _sampler;
+        bgfx::TextureFormat::Enum _format;
+        bgfx::TextureHandle       _th;
+        bgfx::UniformHandle       _uh;
+        bgfx::UniformHandle       _sh;
+        int                       _width;
+        int                       _height;
+        int                       _capacity_width;
+        int                       _capacity_height;
+
+        //+   Static Function    +//
+        static auto _grow (int, int) -> int;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        Texture (const char*, bgfx::TextureFormat::Enum);
+
+        Texture (const Texture&)             = delete;
+        Texture& operator = (const Texture&) = delete;
+
+        //_ Constant Getter
+        auto width          (void) const -> int { return _width; }
+        auto height         (void) const -> int { return _height; }
+        auto capacityWidth  (void) const -> int { return _capacity_width; }
+        auto capacityHeight (void) const -> int { return _capacity_height; }
+
+        //_ Variable Function
+        // 使う大きさを変える. 確保した大きさを超えたときだけ (次の handle() で) 作り直すので, そのときは中身を送り直すこと
+        auto resize  (int, int) -> void;
+        auto handle  (void)     -> bgfx::TextureHandle;
+        auto bind    (uint8_t)  -> void;
+        auto destroy (void)     -> void;
+    };
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef ATPT_THREAD_POOL_HPP
+#define ATPT_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace atpt{
+
+    // 全パネルで共有するワーカースレッド群.
+    // parallelFor を呼んだスレッドも自分の仕事を手伝うので, ワーカーの中から入れ子で呼んでも詰まらない.
+    class ThreadPool{
+
+        //+   Member Variable    +//
+        std::vector<std::thread>          _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex                        _mutex;
+        std::condition_variable           _cv;
+        bool                              _stop;
+
+        //+   Static Variable    +//
+        static int _worker_count;
+
+        public:
+        // setWorkerCount に渡すと, ハードウェアスレッド数 - 1 (呼び出し側も働くため) にする
+        static constexpr int auto_workers = -1;
+
+        //+   Member Function    +//
+        //_ Constructor
+        explicit ThreadPool (size_t);
+
+        //_ Destructor
+        ~ThreadPool ();
+
+        ThreadPool (const ThreadPool&)             = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+
+        //_ Static Function
+        static auto setWorkerCount (int)  -> void;
+        static auto shared         (void) -> ThreadPool&;
+
+        //_ Constant Getter
+        auto size (void) const -> size_t { return _workers.size() + 1; }
+
+        //_ Variable Function
+        template <typename F>           inline auto parallelFor   (int, int, int, F&&) -> void;
+        template <typename G, typename F> inline auto parallelBands (const G&, F&&)      -> void;
+
+        private:
+        //_ Inner Function
+        auto _push   (std::function<void()>) -> void;
+        auto _runOne (void)                  -> bool;
+        auto _work   (void)                  -> void;
+    };
+}
+
+#include "thread_pool.inl"
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef ATPT_THREAD_POOL_INL
+#define ATPT_THREAD_POOL_INL
+
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace atpt{
+
+    // [begin_, end_) を grain_ 以上の区間に分けて f_(b0, b1) を並列に呼ぶ. 全区間が終わるまで戻らない.
+    template <typename F>
+    auto ThreadPool::parallelFor (int begin_, int end_, int grain_, F&& f_)
+        -> void
+    {
+        const int n = end_ - begin_;
+        if (n <= 0) return;
+
+        const int grain  = std::max(grain_, 1);
+        const int chunks = std::min<int>((n + grain - 1) / grain, static_cast<int>(size()) * 4);
+
+        if (chunks <= 1) {
+            f_(begin_, end_);
+            return;
+        }
+
+        std::atomic<int> remaining { chunks - 1 };
+
+        auto bound = [&](int c_) { return begin_ + static_cast<int>(static_cast<long long>(n) * c_ / chunks); };
+
+        for(int c = 1; c < chunks; ++c){
+            _push([&, c]{
+                f_(bound(c), bound(c + 1));
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        f_(bound(0), bound(1));
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (not _runOne()) std::this_thread::yield();
+        }
+    }
+
+
+    // grid_ の行を帯に分けて f_(y0, y1) を並列に呼ぶ. 1帯あたりおよそ 16K セル以上になるようにする
+    template <typename G, typename F>
+    auto ThreadPool::parallelBands (const G& grid_, F&& f_)
+        -> void
+    {
+        const int grain = std::max(1, (1 << 14) / std::max(grid_.width(), 1));
+        parallelFor(0, grid_.height(), grain, std::forward<F>(f_));
+    }
+}
+#endif
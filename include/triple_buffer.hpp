@@ -0,0 +1,49 @@
+#ifndef ATPT_TRIPLE_BUFFER_HPP
+#define ATPT_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace atpt{
+
+    // 書き手 1人と読み手 1人が T を受け渡す待ちなしの三重バッファ.
+    // 書き手は back() に書いて publish() し, 読み手は update() で最新の完成品を front() に取る.
+    // 間の 1枚 (middle) の番号と「まだ読まれていない」印を 1つの atomic にまとめて交換するので, どちらも相手を待たない.
+    // 読み手が追いつかなければ古いフレームは読まれずに上書きされる
+    template <typename T>
+    class TripleBuffer{
+
+        //+   Static Variable    +//
+        static constexpr uint8_t fresh = 4;
+
+        //+   Member Variable    +//
+        std::array<T, 3>     _slots;
+        std::atomic<uint8_t> _middle;
+        uint8_t              _back;
+        uint8_t              _front;
+
+        public:
+        //+   Member Function    +//
+        //_ Constructor
+        TripleBuffer (void) : _slots ( ), _middle { 1 }, _back { 0 }, _front { 2 } { return; }
+
+        TripleBuffer (const TripleBuffer&)             = delete;
+        TripleBuffer& operator = (const TripleBuffer&) = delete;
+
+        //_ Getter
+        // 書き手のスレッドだけが触る
+        auto back  (void) -> T& { return _slots[_back]; }
+        // 読み手のスレッドだけが触る
+        auto front (void) -> T& { return _slots[_front]; }
+
+        //_ Variable Function
+        inline auto publish (void) -> void;
+        inline auto update  (void) -> bool;
+        inline auto reset   (void) -> void;
+    };
+}
+
+#include "triple_buffer.inl"
+
+#endif
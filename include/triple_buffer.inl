@@ -0,0 +1,39 @@
+#ifndef ATPT_TRIPLE_BUFFER_INL
+#define ATPT_TRIPLE_BUFFER_INL
+
+#include "triple_buffer.hpp"
+
+namespace atpt{
+
+    // back を middle に出し, 代わりに前の middle (読まれていてもいなくても) を次の back にする
+    template <typename T>
+    auto TripleBuffer<T>::publish (void)
+        -> void
+    {
+        _back = _middle.exchange(static_cast<uint8_t>(_back | fresh), std::memory_order_acq_rel) & 3;
+    }
+
+
+    // 新しいフレームがあれば front と入れ替えて true を返す. なければ front はそのまま
+    template <typename T>
+    auto TripleBuffer<T>::update (void)
+        -> bool
+    {
+        if (not (_middle.load(std::memory_order_relaxed) & fresh)) return false;
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+
+
+    // 3枚とも空の T に戻してメモリを返す. 書き手も読み手も触っていないときだけ呼ぶこと
+    template <typename T>
+    auto TripleBuffer<T>::reset (void)
+        -> void
+    {
+        for(T& s : _slots) s = T{};
+        _middle.store(1, std::memory_order_release);
+        _back  = 0;
+        _front = 2;
+    }
+}
+#endif
@@ -0,0 +1,34 @@
+$input  v_texcoord0
+#include <bgfx_shader.sh>
+
+// u_tex0 は状態 (R8). u_state.y == 1 ならセル 8個を 1 texel に詰めたもの (下位ビットが左のセル),
+// 8 なら 1 texel 1セル. 色は u_palette (256x1) から引く
+//   u_state.x : 横のセル数
+//   u_state.y : 1セルのビット数 (1 or 8)
+//   u_state.w : 縦のセル数
+// u_texsize.xy は u_tex0 を確保した大きさ (texel). 使っているのはその先頭の部分だけ
+// u_view はグリッド全体を 0-1 としたときに見えている範囲 (xy: 左下, zw: 幅と高さ). 端は周期的につなぐ
+
+#if BGFX_SHADER_LANGUAGE_HLSL
+    SAMPLER2D(u_tex0,    0);
+    SAMPLER2D(u_palette, 1);
+#else
+    SAMPLER2D(u_tex0);
+    SAMPLER2D(u_palette);
+#endif
+
+uniform vec4 u_state;
+uniform vec4 u_view;
+uniform vec4 u_texsize;
+
+void main()
+{
+    vec2  pos    = u_view.xy + v_texcoord0 * u_view.zw;
+    vec2  cell   = mod(floor(pos * u_state.xw), u_state.xw);
+    float is_bit = u_state.y < 4.0 ? 1.0 : 0.0;
+    float texel  = is_bit > 0.5 ? floor(cell.x / 8.0) : cell.x;
+    float value  = floor(texture2D(u_tex0, (vec2(texel, cell.y) + 0.5) / u_texsize.xy).x * 255.0 + 0.5);
+    float index  = is_bit > 0.5 ? mod(floor(value / exp2(cell.x - texel * 8.0)), 2.0) : value;
+
+    gl_FragColor = texture2D(u_palette, vec2((index + 0.5) / 256.0, 0.5));
+}
@@ -1,6 +1,8 @@
 $input  v_texcoord0
 #include <bgfx_shader.sh>
 
+// u_tex0 の先頭 u_texsize.zw texel がグリッド (1 texel 1セル) で, 点サンプリングで拡げて描く. u_texsize.xy は確保した大きさ.
+// u_view はグリッド全体を 0-1 としたときに見えている範囲 (xy: 左下, zw: 幅と高さ). 外は黒
 
 #if BGFX_SHADER_LANGUAGE_HLSL
     SAMPLER2D(u_tex0, 0);
@@ -8,9 +10,14 @@ $input  v_texcoord0
     SAMPLER2D(u_tex0);
 #endif
 
+uniform vec4 u_view;
+uniform vec4 u_texsize;
+
 void main()
 {
-    vec4 c = texture2D(u_tex0, v_texcoord0);
-    gl_FragColor = c;
+    vec2  pos    = u_view.xy + v_texcoord0 * u_view.zw;
+    float inside = step(0.0, pos.x) * step(pos.x, 1.0) * step(0.0, pos.y) * step(pos.y, 1.0);
+    vec2  texel  = min(floor(pos * u_texsize.zw), u_texsize.zw - 1.0);
+    vec4  c      = texture2D(u_tex0, (texel + 0.5) / u_texsize.xy);
+    gl_FragColor = vec4(c.rgb * inside, 1.0);
 }
-
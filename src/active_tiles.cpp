@@ -0,0 +1,69 @@
+#include <active_tiles.hpp>
+#include <algorithm>
+
+namespace atpt{
+
+    // 最初は全タイルを変化ありにしておく (最初のステップは全面を計算する)
+    ActiveTiles::ActiveTiles (int width_, int height_)
+        : _tiles_x ( (width_  + tile_size - 1) >> tile_log )
+        , _tiles_y ( (height_ + tile_size - 1) >> tile_log )
+        , _changed ( static_cast<size_t>(_tiles_x) * _tiles_y, 1 )
+    {
+        return;
+    }
+
+
+    // reach_ タイル先まで (周期境界で折り返す) のどれかが変化していれば計算する
+    auto ActiveTiles::active (int tx_, int ty_, int reach_) const
+        -> bool
+    {
+        if (reach_ == 1) {
+            const int xs[3] = { tx_ == 0 ? _tiles_x - 1 : tx_ - 1, tx_, tx_ == _tiles_x - 1 ? 0 : tx_ + 1 };
+            const int ys[3] = { ty_ == 0 ? _tiles_y - 1 : ty_ - 1, ty_, ty_ == _tiles_y - 1 ? 0 : ty_ + 1 };
+
+            for(int y : ys){
+                const uint8_t* row = _changed.data() + static_cast<size_t>(y) * _tiles_x;
+                if (row[xs[0]] | row[xs[1]] | row[xs[2]]) return true;
+            }
+            return false;
+        }
+
+        for(int dy = -reach_; dy <= reach_; ++dy){
+            const int      y   = ((ty_ + dy) % _tiles_y + _tiles_y) % _tiles_y;
+            const uint8_t* row = _changed.data() + static_cast<size_t>(y) * _tiles_x;
+            for(int dx = -reach_; dx <= reach_; ++dx){
+                if (row[((tx_ + dx) % _tiles_x + _tiles_x) % _tiles_x]) return true;
+            }
+        }
+        return false;
+    }
+
+
+    auto ActiveTiles::count (void) const
+        -> size_t
+    {
+        return static_cast<size_t>(std::count(_changed.begin(), _changed.end(), uint8_t{1}));
+    }
+
+
+    auto ActiveTiles::markAll (void)
+        -> void
+    {
+        std::fill(_changed.begin(), _changed.end(), uint8_t{1});
+    }
+
+
+    // グリッドの中身が入れ替わるので全タイルを変化ありにする
+    auto ActiveTiles::resize (int width_, int height_)
+        -> int
+    {
+        _tiles_x = (width_  + tile_size - 1) >> tile_log;
+        _tiles_y = (height_ + tile_size - 1) >> tile_log;
+
+        const size_t n = static_cast<size_t>(_tiles_x) * _tiles_y;
+        if (n > _changed.capacity()) _changed.reserve(n + n / 2);
+        _changed.assign(n, 1);
+
+        return 0;
+    }
+}
@@ -1,15 +1,22 @@
 #include <bad_noise.hpp>
+#include <lfsr.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 namespace atpt{
 
     BadNoise::BadNoise (SDL_Window* wd_, uint32_t seed_)
-        : Panel    ( "Bad Noise", wd_, "shaders/fs_texture.bin" )
-        , _uh      ( bgfx::createUniform("u_tex0", bgfx::UniformType::Sampler) )
-        , _th      ( bgfx::createTexture2D(static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), false, 1, bgfx::TextureFormat::BGRA8, 0) )
-        , _pixels  ( _width * _height )
-        , _seed    { seed_ }
-        , _invar   ( _seed )
+        : Panel       ( "Bad Noise", wd_, "shaders/fs_palette.bin" )
+        , _sh         ( BGFX_INVALID_HANDLE )
+        , _texture    ( "u_tex0", bgfx::TextureFormat::R8 )
+        , _states     ( 0, 0 )
+        , _frames     ( )
+        , _palette    { 0xFF000000u, 0xFF13A00Eu }
+        , _generation { 0 }
+        , _seed       { seed_ }
+        , _invar      ( _seed )
     {
         return;
     }
@@ -18,31 +25,97 @@ namespace atpt{
     auto BadNoise::_resize (int o_width_, int o_height_)
         -> int
     {
-        _pixels.assign( static_cast<size_t>(this->_width) * static_cast<size_t>(this->_height), 0);
-       
-        if (bgfx::isValid(_th)) bgfx::destroy(_th);
-        _th = bgfx::createTexture2D(static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), false, 1, bgfx::TextureFormat::BGRA8, 0); 
+        _states.resize(((_width + 63) / 64) * 8, _height);
+        _texture.resize(_states.width(), _states.height());
         
         return 0;
     }
 
 
-    auto BadNoise::_draw (void)
+    auto BadNoise::_activate (void)
         -> int
     {
-        for (size_t i = 0; i < _pixels.size(); ++i) {
-            uint32_t tmp = ((_invar >> 0) ^ (_invar >> 2)) & 1;
-            _invar = (_invar >> 1) | (tmp << 31);
-            _pixels[i] = (_invar & 1) ? 0xFF13A00Eu : 0xFF000000u;
+        _states.resize(((_width + 63) / 64) * 8, _height);
+        _texture.resize(_states.width(), _states.height());
+
+        _sh = bgfx::createUniform("u_state", bgfx::UniformType::Vec4);
+
+        return 0;
+    }
+
+
+    auto BadNoise::_step (bool publish_, int count_)
+        -> int
+    {
+        const int width  = _width;
+        const int height = _height;
+
+        // 表示しない世代は LFSR をその分のフレームだけ飛ばす (出したときと同じ列になる)
+        const int skip = publish_ ? count_ - 1 : count_;
+        if (skip > 0) {
+            Lfsr32 lfsr(_invar);
+            lfsr.jump(static_cast<uint64_t>(width) * height * skip);
+            _invar = lfsr.state();
+            _generation += skip;
         }
+        if (not publish_) return 0;
+
+        StateFrame& f = _frames.back();
+        f.width  = ((width + 63) / 64) * 8;
+        f.height = height;
+        f.pixels.resize(static_cast<size_t>(f.width) * f.height);
+
+        // ピクセル (a, b) は列の b * width + a 番目. 行の幅は 64 の倍数とは限らないので,
+        // 64bit ずつ作った列を carry に残しながら行に詰める
+        ThreadPool::shared().parallelFor(0, height, 64, [&](int b0_, int b1_){
+            Lfsr32 lfsr(_invar);
+            lfsr.jump(static_cast<uint64_t>(b0_) * width);
 
-        // pixels → GPUに転送
-        const bgfx::Memory* mem = bgfx::copy(
-            _pixels.data(), (uint32_t)(_pixels.size() * sizeof(uint32_t))
-        );
-        bgfx::updateTexture2D(_th, 0, 0, 0, 0, static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), mem);
+            uint64_t carry = 0;
+            int      have  = 0;
+            for(int b = b0_; b < b1_; ++b){
+                uint8_t* row = f.pixels.data() + static_cast<size_t>(b) * f.width;
+                for(int a = 0; a < width; a += 64){
+                    const int      n    = std::min(64, width - a);
+                    const uint64_t mask = n == 64 ? ~uint64_t{0} : (uint64_t{1} << n) - 1;
+                    uint64_t       w;
+                    if (have >= n) {
+                        w       = carry & mask;
+                        carry >>= n;
+                        have   -= n;
+                    }else{
+                        const uint64_t fresh = lfsr.next64();
+                        const int      used  = n - have;
+                        w     = (carry | (fresh << have)) & mask;
+                        carry = used == 64 ? 0 : fresh >> used;
+                        have  = 64 - used;
+                    }
+                    std::memcpy(row + a / 8, &w, sizeof(w));
+                }
+            }
+        });
+
+        Lfsr32 lfsr(_invar);
+        lfsr.jump(static_cast<uint64_t>(width) * height);
+        _invar = lfsr.state();
+
+        f.generation = ++_generation;
+        _frames.publish();
+
+        return 0;
+    }
+
+
+    auto BadNoise::_present (void)
+        -> int
+    {
+        // pixels → GPUに転送 (コピーせず参照で渡す). 見えている範囲だけ
+        if (_frames.update() or _moved) _states.uploadFrame(_frames.front(), 0, _texture.handle(), _visibleTexels(8));
 
-        bgfx::setTexture(0, _uh, _th);
+        const float state[4] = { static_cast<float>(_width), 1.0f, 0.0f, static_cast<float>(_height) };
+        _texture.bind(0);
+        bgfx::setUniform(_sh, state);
+        _palette.bind(1);
         
         return 0;
     }
@@ -67,11 +140,16 @@ namespace atpt{
     }
 
 
-    auto BadNoise::_destroy (void)
+    // フレームは毎回全面を作り直すので, 置き場ごと手放してよい
+    auto BadNoise::_deactivate (void)
         -> int
     {
-        if (bgfx::isValid(_th)) bgfx::destroy(_th);
-        if (bgfx::isValid(_uh)) bgfx::destroy(_uh);
+        if (bgfx::isValid(_sh)) bgfx::destroy(_sh);
+        _sh = BGFX_INVALID_HANDLE;
+        _texture.destroy();
+        _palette.destroy();
+        _frames.reset();
+        _states.release();
         
         return 0;
     }
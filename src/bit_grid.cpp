@@ -0,0 +1,112 @@
+#include <bit_grid.hpp>
+#include <algorithm>
+
+namespace atpt{
+
+    PeriodicBoundaryBitGrid::PeriodicBoundaryBitGrid (int width_, int height_)
+        : _width  (width_)
+        , _height (height_)
+        , _words  ((width_ + 63) / 64)
+        , _vector (static_cast<size_t>(_words + 2) * (_height + 2), 0)
+    {
+        return;
+    }
+
+
+    auto PeriodicBoundaryBitGrid::tailMask (void) const
+        -> uint64_t
+    {
+        return (_width & 63) ? (uint64_t{1} << (_width & 63)) - 1 : ~uint64_t{0};
+    }
+
+
+    auto PeriodicBoundaryBitGrid::set (int x_, int y_, bool v_)
+        -> void
+    {
+        uint64_t& w   = row(y_)[x_ >> 6];
+        uint64_t  bit = uint64_t{1} << (x_ & 63);
+        w = v_ ? (w | bit) : (w & ~bit);
+    }
+
+
+    // 確保済みの中に収まる間はその場で詰め直し, 取り直さない (FreeBoundaryGrid::resize と同じ手順)
+    auto PeriodicBoundaryBitGrid::resize (int nw_, int nh_)
+        -> int
+    {
+        const int      nwords  = (nw_ + 63) / 64;
+        const int      ostride = stride();
+        const int      nstride = nwords + 2;
+        const int      rows    = std::min(_height, nh_);
+        const int      cols    = std::min(_words,  nwords);
+        const uint64_t omask   = tailMask();
+        const size_t   osize   = _vector.size();
+        const size_t   nsize   = static_cast<size_t>(nstride) * (nh_ + 2);
+
+        if (nsize > _vector.capacity()) _vector.reserve(nsize + nsize / 2);
+        if (nsize > osize)              _vector.resize(nsize, 0);
+
+        uint64_t* const d = _vector.data();
+        if (nstride > ostride) {
+            for(int a = rows - 1; a >= 0; --a){
+                uint64_t* const src = d + static_cast<size_t>(a + 1) * ostride + 1;
+                std::copy_backward(src, src + cols, d + static_cast<size_t>(a + 1) * nstride + 1 + cols);
+            }
+        }else if (nstride < ostride) {
+            for(int a = 0; a < rows; ++a){
+                uint64_t* const src = d + static_cast<size_t>(a + 1) * ostride + 1;
+                std::copy(src, src + cols, d + static_cast<size_t>(a + 1) * nstride + 1);
+            }
+        }
+        if (nsize < osize) _vector.resize(nsize);
+
+        for(int a = -1; a < nh_ + 1; ++a){
+            uint64_t* const r = d + static_cast<size_t>(a + 1) * nstride;
+            if (a < 0 or a >= rows) {
+                std::fill(r, r + nstride, 0);
+            }else{
+                // 元の最後のワードには幅の外に周期境界用のビットが入っているので落としておく
+                if (cols == _words and cols > 0) r[cols] &= omask;
+                r[0] = 0;
+                std::fill(r + 1 + cols, r + nstride, 0);
+            }
+        }
+
+        _width  = nw_;
+        _height = nh_;
+        _words  = nwords;
+
+        // 縮小した場合は幅の外に出たビットを落とす
+        const uint64_t mask = tailMask();
+        if (_words > 0) for(int a = 0; a < _height; ++a) row(a)[_words - 1] &= mask;
+
+        fillHalo();
+        return 0;
+    }
+
+
+    auto PeriodicBoundaryBitGrid::fillHalo (void)
+        -> void
+    {
+        if (_width == 0 or _height == 0) return;
+
+        const int      last = _words - 1;
+        const int      pad  = _width & 63;
+        const uint64_t mask = tailMask();
+
+        for(int b = 0; b < _height; ++b){
+            uint64_t*      r     = row(b);
+            const uint64_t first = r[0] & 1u;
+
+            r[-1] = ((r[last] >> ((_width - 1) & 63)) & 1u) << 63;
+            if (pad) {
+                r[last]   = (r[last] & mask) | (first << pad);
+                r[_words] = 0;
+            }else{
+                r[_words] = first;
+            }
+        }
+
+        std::copy(row(_height - 1) - 1, row(_height - 1) - 1 + stride(), row(-1) - 1);
+        std::copy(row(0) - 1,           row(0) - 1 + stride(),           row(_height) - 1);
+    }
+}
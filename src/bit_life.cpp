@@ -0,0 +1,27 @@
+#include <bit_life.hpp>
+#include <atomic>
+
+namespace atpt{
+
+    namespace{
+
+        // 起動時に一度だけ CPU を調べて決める. 行カーネル自体は規則ごとに bit_life.inl で生成される
+        std::atomic<SimdLevel> _level { detectSimdLevel() };
+    }
+
+
+    auto setBitLifeSimdLevel (SimdLevel level_)
+        -> void
+    {
+        // CPU が対応していない命令セットには落とさない
+        if (level_ > detectSimdLevel()) level_ = detectSimdLevel();
+        _level.store(level_);
+    }
+
+
+    auto bitLifeSimdLevel (void)
+        -> SimdLevel
+    {
+        return _level.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,57 @@
+#include <cpu_features.hpp>
+
+#if ATPT_X86 && defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+namespace atpt{
+
+    auto detectSimdLevel (void)
+        -> SimdLevel
+    {
+#if ATPT_X86 && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2"))    return SimdLevel::SSE2;
+        return SimdLevel::Scalar;
+#elif ATPT_X86 && defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        const int max_leaf = regs[0];
+
+        __cpuid(regs, 1);
+        const bool sse2    = (regs[3] >> 26) & 1;
+        const bool osxsave = (regs[2] >> 27) & 1;
+
+        bool avx2   = false;
+        bool avx512 = false;
+        if (osxsave and max_leaf >= 7) {
+            const unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(regs, 7, 0);
+            avx2   = ((xcr0 & 0x06) == 0x06) and ((regs[1] >> 5) & 1);
+            avx512 = ((xcr0 & 0xE6) == 0xE6) and ((regs[1] >> 16) & 1);
+        }
+
+        if (avx512) return SimdLevel::AVX512;
+        if (avx2)   return SimdLevel::AVX2;
+        if (sse2)   return SimdLevel::SSE2;
+        return SimdLevel::Scalar;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+
+    auto simdLevelName (SimdLevel level_)
+        -> const char*
+    {
+        switch (level_) {
+            case SimdLevel::AVX512: return "AVX-512";
+            case SimdLevel::AVX2:   return "AVX2";
+            case SimdLevel::SSE2:   return "SSE2";
+            default:                return "Scalar";
+        }
+    }
+}
@@ -0,0 +1,416 @@
+#include <hash_life.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+namespace atpt{
+
+    namespace{
+
+        constexpr HashLife::Index kNone = 0xFFFFFFFFu;
+        constexpr uint8_t         kFree = 0xFF;
+        constexpr int             kMaxLevel = 60;
+    }
+
+
+    //+   Member Function    +//
+    //_ Constructor
+    HashLife::HashLife (size_t max_nodes_)
+        : _nodes      ( )
+        , _free       ( )
+        , _table      ( )
+        , _empty      ( )
+        , _roots      ( )
+        , _live       { 0 }
+        , _max_nodes  { max_nodes_ }
+        , _limit      { max_nodes_ }
+        , _root       { 0 }
+        , _step_log   { 0 }
+        , _generation { 0 }
+    {
+        clear();
+        return;
+    }
+
+
+    //_ Constant Getter
+    auto HashLife::rasterize (int64_t x0_, int64_t y0_, int w_, int h_, int scale_log_, uint32_t* pixels_, uint32_t on_, uint32_t off_) const
+        -> void
+    {
+        std::fill(pixels_, pixels_ + static_cast<size_t>(w_) * h_, off_);
+
+        const int     lv   = _nodes[_root].level;
+        const int64_t half = int64_t{1} << (lv - 1);
+        _raster(_root, -half, -half, x0_, y0_, w_, h_, scale_log_, pixels_, on_);
+    }
+
+
+    auto HashLife::_raster (Index n_, int64_t nx_, int64_t ny_, int64_t x0_, int64_t y0_, int w_, int h_, int s_, uint32_t* pixels_, uint32_t on_) const
+        -> void
+    {
+        const Node& n = _nodes[n_];
+        if (n.population == 0) return;
+
+        const int64_t size = int64_t{1} << n.level;
+        if (nx_ + size <= x0_ or nx_ >= x0_ + (static_cast<int64_t>(w_) << s_)) return;
+        if (ny_ + size <= y0_ or ny_ >= y0_ + (static_cast<int64_t>(h_) << s_)) return;
+
+        // 1ピクセルに収まる大きさまで降りたら点を打つ
+        if (n.level <= s_) {
+            const int64_t px = (nx_ - x0_) >> s_;
+            const int64_t py = (ny_ - y0_) >> s_;
+            if (px >= 0 and px < w_ and py >= 0 and py < h_) pixels_[py * w_ + px] = on_;
+            return;
+        }
+
+        const int64_t q = size / 2;
+        _raster(n.nw, nx_,     ny_,     x0_, y0_, w_, h_, s_, pixels_, on_);
+        _raster(n.ne, nx_ + q, ny_,     x0_, y0_, w_, h_, s_, pixels_, on_);
+        _raster(n.sw, nx_,     ny_ + q, x0_, y0_, w_, h_, s_, pixels_, on_);
+        _raster(n.se, nx_ + q, ny_ + q, x0_, y0_, w_, h_, s_, pixels_, on_);
+    }
+
+
+    //_ Variable Function
+    auto HashLife::clear (void)
+        -> void
+    {
+        _nodes.clear();
+        _free.clear();
+        _empty.clear();
+        _live       = 0;
+        _generation = 0;
+
+        // 0: 死んだセル, 1: 生きたセル (level 0 の葉はハッシュ表に入れない)
+        _nodes.push_back(Node{ kNone, kNone, kNone, kNone, kNone, 0, false, 0 });
+        _nodes.push_back(Node{ kNone, kNone, kNone, kNone, kNone, 0, false, 1 });
+
+        _table.assign(size_t{1} << 16, kNone);
+        _root = _emptyNode(3);
+    }
+
+
+    // grid_ を左上 (x0_, y0_) に置いたパターンで置き換える
+    auto HashLife::load (const PeriodicBoundaryBitGrid& grid_, int64_t x0_, int64_t y0_)
+        -> void
+    {
+        clear();
+
+        const int64_t extent = std::max({ std::abs(x0_), std::abs(y0_),
+                                          std::abs(x0_ + grid_.width()), std::abs(y0_ + grid_.height()) });
+        int lv = 3;
+        while (lv < kMaxLevel and (int64_t{1} << (lv - 1)) < extent) ++lv;
+
+        const int64_t half = int64_t{1} << (lv - 1);
+        _root = _build(lv, -half, -half, grid_, x0_, y0_);
+    }
+
+
+    // 2^k_ 世代進める. 既に進めた世代に比べてパターンがはみ出さないよう, 先にルートを広げる
+    auto HashLife::advance (int k_)
+        -> int
+    {
+        if (k_ < 0 or k_ > kMaxLevel - 3) return 1;
+
+        _limit = _max_nodes;
+        if (_live > _limit) collect();
+
+        if (k_ != _step_log) {
+            _step_log = k_;
+            _clearMemo();
+        }
+
+        // ルートの中央の中央にパターンが収まり, かつ 2^k_ <= 2^(level-3) になるまで広げる
+        while (true) {
+            const int lv = _nodes[_root].level;
+            if (lv >= kMaxLevel) return 1;
+            if (lv >= k_ + 3) {
+                const Index cc = _center(_center(_root));
+                if (_nodes[cc].population == _nodes[_root].population) break;
+            }
+            _expand();
+        }
+
+        _root        = _result(_root);
+        _generation += uint64_t{1} << k_;
+
+        return 0;
+    }
+
+
+    // ルート, 空ノード, 計算中のノード (_roots) から辿れるものだけを残す. 再帰の途中からも呼ばれる
+    auto HashLife::collect (void)
+        -> void
+    {
+        for(Node& n : _nodes) n.mark = false;
+
+        _mark(_root);
+        for(Index e : _empty) _mark(e);
+        for(Index r : _roots) _mark(r);
+
+        _sweep();
+        _limit = std::max(_max_nodes, _live * 2);
+    }
+
+
+    //_ Inner Function
+    auto HashLife::_hash (Index nw_, Index ne_, Index sw_, Index se_) const
+        -> size_t
+    {
+        uint64_t h = (static_cast<uint64_t>(nw_) << 32 | ne_) * 0x9E3779B97F4A7C15ull;
+        h ^= (static_cast<uint64_t>(sw_) << 32 | se_) * 0xC2B2AE3D27D4EB4Full;
+        h ^= h >> 29;
+        return static_cast<size_t>(h);
+    }
+
+
+    auto HashLife::_join (Index nw_, Index ne_, Index sw_, Index se_)
+        -> Index
+    {
+        const size_t mask = _table.size() - 1;
+        size_t       slot = _hash(nw_, ne_, sw_, se_) & mask;
+
+        for(; _table[slot] != kNone; slot = (slot + 1) & mask){
+            const Node& n = _nodes[_table[slot]];
+            if (n.nw == nw_ and n.ne == ne_ and n.sw == sw_ and n.se == se_) return _table[slot];
+        }
+
+        const uint8_t  lv  = _nodes[nw_].level + 1;
+        const uint64_t pop = _nodes[nw_].population + _nodes[ne_].population
+                           + _nodes[sw_].population + _nodes[se_].population;
+
+        Index id;
+        if (_free.empty()) {
+            id = static_cast<Index>(_nodes.size());
+            _nodes.push_back(Node{ nw_, ne_, sw_, se_, kNone, lv, false, pop });
+        }else{
+            id = _free.back();
+            _free.pop_back();
+            _nodes[id] = Node{ nw_, ne_, sw_, se_, kNone, lv, false, pop };
+        }
+
+        _table[slot] = id;
+        ++_live;
+        if (_live * 2 > _table.size()) _rehash(_table.size() * 2);
+
+        return id;
+    }
+
+
+    auto HashLife::_insert (Index id_)
+        -> void
+    {
+        const Node&  n    = _nodes[id_];
+        const size_t mask = _table.size() - 1;
+        size_t       slot = _hash(n.nw, n.ne, n.sw, n.se) & mask;
+        while (_table[slot] != kNone) slot = (slot + 1) & mask;
+        _table[slot] = id_;
+    }
+
+
+    auto HashLife::_rehash (size_t size_)
+        -> void
+    {
+        _table.assign(size_, kNone);
+        for(Index i = 2; i < _nodes.size(); ++i){
+            if (_nodes[i].level != kFree) _insert(i);
+        }
+    }
+
+
+    auto HashLife::_emptyNode (int level_)
+        -> Index
+    {
+        if (_empty.empty()) _empty.push_back(0);
+        while (static_cast<int>(_empty.size()) <= level_) {
+            const Index e = _empty.back();
+            _empty.push_back(_join(e, e, e, e));
+        }
+        return _empty[level_];
+    }
+
+
+    auto HashLife::_center (Index n_)
+        -> Index
+    {
+        const Node n = _nodes[n_];
+        return _join(_nodes[n.nw].se, _nodes[n.ne].sw, _nodes[n.sw].ne, _nodes[n.se].nw);
+    }
+
+
+    // level 2 (4x4) の中央 2x2 を1世代進める
+    auto HashLife::_base (Index n_)
+        -> Index
+    {
+        const Node n = _nodes[n_];
+
+        int cell[4][4];
+        const Index quads[4] = { n.nw, n.ne, n.sw, n.se };
+        for(int q = 0; q < 4; ++q){
+            const Node& c  = _nodes[quads[q]];
+            const int   ox = (q & 1) * 2;
+            const int   oy = (q >> 1) * 2;
+            cell[oy    ][ox    ] = static_cast<int>(_nodes[c.nw].population);
+            cell[oy    ][ox + 1] = static_cast<int>(_nodes[c.ne].population);
+            cell[oy + 1][ox    ] = static_cast<int>(_nodes[c.sw].population);
+            cell[oy + 1][ox + 1] = static_cast<int>(_nodes[c.se].population);
+        }
+
+        Index out[4];
+        for(int b = 1; b <= 2; ++b){
+            for(int a = 1; a <= 2; ++a){
+                const int sum = cell[b - 1][a - 1] + cell[b - 1][a] + cell[b - 1][a + 1]
+                              + cell[b    ][a - 1]                  + cell[b    ][a + 1]
+                              + cell[b + 1][a - 1] + cell[b + 1][a] + cell[b + 1][a + 1];
+                out[(b - 1) * 2 + (a - 1)] = (sum == 3 or (cell[b][a] and sum == 2)) ? 1 : 0;
+            }
+        }
+
+        return _join(out[0], out[1], out[2], out[3]);
+    }
+
+
+    // level L のノードの中央 (level L-1) を 2^min(step_log, L-2) 世代進めたもの
+    auto HashLife::_result (Index n_)
+        -> Index
+    {
+        if (_nodes[n_].result != kNone) return _nodes[n_].result;
+
+        const Node n  = _nodes[n_];
+        const int  lv = n.level;
+
+        Index r;
+        if (n.population == 0) {
+            r = _emptyNode(lv - 1);
+        }else if (lv == 2) {
+            r = _base(n_);
+        }else{
+            // 子の _result で回収が走っても消えないよう, このノードと計算中のノードは _roots に積んでおく
+            const size_t top = _roots.size();
+            _roots.push_back(n_);
+            if (_live > _limit) collect();
+
+            const Node a = _nodes[n.nw];
+            const Node b = _nodes[n.ne];
+            const Node c = _nodes[n.sw];
+            const Node d = _nodes[n.se];
+
+            // 重なり合う 9 個の level L-1 ノード
+            _roots.insert(_roots.end(), {
+                n.nw,                             _join(a.ne, b.nw, a.se, b.sw), n.ne,
+                _join(a.sw, a.se, c.nw, c.ne),    _join(a.se, b.sw, c.ne, d.nw), _join(b.sw, b.se, d.nw, d.ne),
+                n.sw,                             _join(c.ne, d.nw, c.se, d.sw), n.se,
+            });
+            auto sub = [&](int i_) -> Index& { return _roots[top + 1 + i_]; };
+
+            // 全速なら 9 個も進めて 2 段で 2^(L-2), そうでなければ中央を取るだけにして 2^step_log
+            const bool full = _step_log >= lv - 2;
+            for(int i = 0; i < 9; ++i) sub(i) = full ? _result(sub(i)) : _center(sub(i));
+
+            // 9 個は 4 個の q の子として辿れるので, 積んでおくのは q だけでよい
+            const Index q[4] = {
+                _join(sub(0), sub(1), sub(3), sub(4)),
+                _join(sub(1), sub(2), sub(4), sub(5)),
+                _join(sub(3), sub(4), sub(6), sub(7)),
+                _join(sub(4), sub(5), sub(7), sub(8)),
+            };
+            _roots.resize(top + 1);
+            _roots.insert(_roots.end(), std::begin(q), std::end(q));
+
+            for(int i = 0; i < 4; ++i) sub(i) = _result(sub(i));
+            r = _join(sub(0), sub(1), sub(2), sub(3));
+            _nodes[n_].result = r;
+            _roots.resize(top);
+            return r;
+        }
+
+        _nodes[n_].result = r;
+        return r;
+    }
+
+
+    // 中心を保ったままルートを1段大きくする
+    auto HashLife::_expand (void)
+        -> void
+    {
+        const Node  n = _nodes[_root];
+        const Index e = _emptyNode(n.level - 1);
+
+        const Index nw = _join(e, e, e, n.nw);
+        const Index ne = _join(e, e, n.ne, e);
+        const Index sw = _join(e, n.sw, e, e);
+        const Index se = _join(n.se, e, e, e);
+        _root = _join(nw, ne, sw, se);
+    }
+
+
+    auto HashLife::_clearMemo (void)
+        -> void
+    {
+        for(Node& n : _nodes) n.result = kNone;
+    }
+
+
+    // 印のないノードを空きにし, 末尾の空きを切り詰めてハッシュ表を作り直す. メモは結果も残ったものだけ持ち越す.
+    // 空きは小さい番号から使うので, 後から作るノードも前に詰まり, 次の回収で切り詰められる
+    auto HashLife::_sweep (void)
+        -> void
+    {
+        size_t end = 2;
+        _live = 0;
+        for(Index i = 2; i < _nodes.size(); ++i){
+            Node& n = _nodes[i];
+            if (not n.mark) n.level = kFree;
+            if (n.level == kFree) continue;
+
+            if (n.result != kNone and not _nodes[n.result].mark) n.result = kNone;
+            ++_live;
+            end = i + 1;
+        }
+
+        _nodes.resize(end);
+        if (_nodes.capacity() > 2 * end + 1024) _nodes.shrink_to_fit();
+
+        _free.clear();
+        for(Index i = static_cast<Index>(end); i-- > 2; ){
+            if (_nodes[i].level == kFree) _free.push_back(i);
+        }
+
+        size_t size = size_t{1} << 16;
+        while (size < _live * 4) size *= 2;
+        _rehash(size);
+    }
+
+
+    auto HashLife::_mark (Index n_)
+        -> void
+    {
+        if (n_ < 2 or _nodes[n_].mark) return;
+        _nodes[n_].mark = true;
+
+        const Node& n = _nodes[n_];
+        _mark(n.nw);
+        _mark(n.ne);
+        _mark(n.sw);
+        _mark(n.se);
+    }
+
+
+    // (nx_, ny_) を左上とする level_ のノードを grid_ から作る
+    auto HashLife::_build (int level_, int64_t nx_, int64_t ny_, const PeriodicBoundaryBitGrid& grid_, int64_t x0_, int64_t y0_)
+        -> Index
+    {
+        const int64_t size = int64_t{1} << level_;
+        if (nx_ + size <= x0_ or nx_ >= x0_ + grid_.width() or
+            ny_ + size <= y0_ or ny_ >= y0_ + grid_.height()) return _emptyNode(level_);
+
+        if (level_ == 0) return grid_(static_cast<int>(nx_ - x0_), static_cast<int>(ny_ - y0_)) ? 1 : 0;
+
+        const int64_t q  = size / 2;
+        const Index   nw = _build(level_ - 1, nx_,     ny_,     grid_, x0_, y0_);
+        const Index   ne = _build(level_ - 1, nx_ + q, ny_,     grid_, x0_, y0_);
+        const Index   sw = _build(level_ - 1, nx_,     ny_ + q, grid_, x0_, y0_);
+        const Index   se = _build(level_ - 1, nx_ + q, ny_ + q, grid_, x0_, y0_);
+        return _join(nw, ne, sw, se);
+    }
+}
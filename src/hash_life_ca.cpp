@@ -0,0 +1,123 @@
+#include <hash_life_ca.hpp>
+#include <random_bits.hpp>
+#include <cstdint>
+
+namespace atpt{
+
+    HashLifeCA::HashLifeCA (SDL_Window* wd_, uint32_t seed_, size_t max_nodes_)
+        : Panel       ( "HashLife", wd_, "shaders/fs_texture.bin" )
+        , _texture    ( "u_tex0", bgfx::TextureFormat::BGRA8 )
+        , _frames     ( )
+        , _life       ( max_nodes_ )
+        , _generation { 0 }
+        , _seed       { seed_ }
+        , _step_log   { 0 }
+        , _scale_log  { 0 }
+        , _loaded     { false }
+    {
+        return;
+    }
+
+
+    auto HashLifeCA::_resize (int o_width_, int o_height_)
+        -> int
+    {
+        _texture.resize(_width, _height);
+
+        return 0;
+    }
+
+
+    // 初めて表示するときに, 窓と同じ大きさの乱数スープを原点中心に置く
+    auto HashLifeCA::_activate (void)
+        -> int
+    {
+        if (not _loaded) {
+            PeriodicBoundaryBitGrid soup(_width, _height);
+            randomizeGrid(soup, _seed);
+            _life.load(soup, -_width / 2, -_height / 2);
+            _loaded = true;
+        }
+
+        _texture.resize(_width, _height);
+
+        return 0;
+    }
+
+
+    auto HashLifeCA::_step (bool publish_, int count_)
+        -> int
+    {
+        for(int i = 0; i < count_; ++i){
+            if (int ret = _life.advance(_step_log)) return ret;
+        }
+        _generation += count_ - 1;
+        if (not publish_) {
+            ++_generation;
+            return 0;
+        }
+
+        PixelFrame& f = _frames.back();
+        f.width  = _width;
+        f.height = _height;
+        f.pixels.resize(static_cast<size_t>(f.width) * f.height);
+
+        const int64_t x0 = -((static_cast<int64_t>(_width)  << _scale_log) / 2);
+        const int64_t y0 = -((static_cast<int64_t>(_height) << _scale_log) / 2);
+        _life.rasterize(x0, y0, _width, _height, _scale_log, f.pixels.data(), 0xFF13A00Eu, 0xFF000000u);
+
+        f.generation = ++_generation;
+        _frames.publish();
+
+        return 0;
+    }
+
+
+    auto HashLifeCA::_present (void)
+        -> int
+    {
+        // pixels → GPUに転送 (コピーせず参照で渡す). 見えている範囲だけ
+        if (_frames.update() or _moved) _pixels.uploadFrame(_frames.front(), 0, _texture.handle(), _visible);
+
+        _texture.bind(0);
+
+        return 0;
+    }
+
+
+    auto HashLifeCA::_event (const SDL_Event& e_)
+        -> int
+    {
+        if (e_.type == SDL_KEYDOWN){
+            switch (e_.key.keysym.sym) {
+                case SDLK_RIGHT:
+                    if (_step_log < 40) ++_step_log;
+                    break;
+                case SDLK_LEFT:
+                    if (_step_log > 0)  --_step_log;
+                    break;
+                case SDLK_PAGEUP:
+                    if (_scale_log < 30) ++_scale_log;
+                    break;
+                case SDLK_PAGEDOWN:
+                    if (_scale_log > 0)  --_scale_log;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return 0;
+    }
+
+
+    // 盤面は残し, 盤面から辿れないノードを空きに戻す. 残ったノードのメモは (結果も残っていれば) 次に使うときまで持ち越す
+    auto HashLifeCA::_deactivate (void)
+        -> int
+    {
+        _texture.destroy();
+        _frames.reset();
+        _life.collect();
+
+        return 0;
+    }
+}
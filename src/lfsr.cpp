@@ -0,0 +1,39 @@
+#include <lfsr.hpp>
+#include <bit>
+
+namespace atpt{
+
+    namespace{
+
+        auto apply (const Lfsr32::Matrix& m_, uint32_t v_) -> uint32_t
+        {
+            uint32_t r = 0;
+            for(; v_; v_ &= v_ - 1) r ^= m_[std::countr_zero(v_)];
+            return r;
+        }
+
+        // _powers[i] = (1ステップの遷移行列)^(2^i)
+        const std::array<Lfsr32::Matrix, 64> _powers = []{
+            std::array<Lfsr32::Matrix, 64> p{};
+            for(int j = 0; j < 32; ++j){
+                Lfsr32 l(uint32_t{1} << j);
+                l.step();
+                p[0][j] = l.state();
+            }
+            for(int i = 1; i < 64; ++i){
+                for(int j = 0; j < 32; ++j) p[i][j] = apply(p[i - 1], p[i - 1][j]);
+            }
+            return p;
+        }();
+    }
+
+
+    // n_ ステップ先の状態へ飛ぶ (出力は捨てる). 行列とベクトルの積を高々 64回
+    auto Lfsr32::jump (uint64_t n_)
+        -> void
+    {
+        for(int i = 0; n_; ++i, n_ >>= 1){
+            if (n_ & 1u) _state = apply(_powers[i], _state);
+        }
+    }
+}
@@ -10,15 +10,27 @@
 #include <fstream>
 
 #include <panel_set.hpp>
+#include <shader_cache.hpp>
+#include <simulation.hpp>
+#include <thread_pool.hpp>
 #include <noise.hpp>
 #include <bad_noise.hpp>
-#include <conway_ca.hpp>
+#include <life_like_ca.hpp>
+#include <hash_life_ca.hpp>
 
 //constexpr int WINDOW_WIDTH  = 1280;
 //constexpr int WINDOW_HEIGHT = 720;
 constexpr int WINDOW_WIDTH  = 256;
 constexpr int WINDOW_HEIGHT = 256;
 
+// Worker threads for grid stepping (auto_workers = hardware concurrency - 1, 0 = the calling thread only)
+constexpr int WORKER_COUNT = atpt::ThreadPool::auto_workers;
+
+// Window pixels per cell, and the simulation size in cells (0 = fit the window or tile)
+constexpr int CELL_SIZE   = 1;
+constexpr int GRID_WIDTH  = 0;
+constexpr int GRID_HEIGHT = 0;
+
 int main()
 {
     // Initialize SDL for video
@@ -89,20 +101,32 @@ int main()
         init.resolution.width  = static_cast<uint32_t>(width);
         init.resolution.height = static_cast<uint32_t>(height);
     }
-    init.resolution.reset  = BGFX_RESET_VSYNC;
+    init.resolution.reset  = atpt::Panel::resetFlags();
     if (!bgfx::init(init)) {
         std::cerr << "bgfx::init failed\n";
         SDL_DestroyWindow(window);
         SDL_Quit();
     }
 
+    // Start the shared worker threads before any panel uses them
+    atpt::ThreadPool::setWorkerCount(WORKER_COUNT);
+    atpt::ThreadPool::shared();
+
     // Create panel manager
     atpt::PanelSet panels(window);
+    panels.setCellSize(CELL_SIZE);
+    panels.setGridSize(GRID_WIDTH, GRID_HEIGHT);
 
     // Add two panels (Noise and BadNoise)
-    atpt::Noise&    noise     = panels.createPanel<atpt::Noise>(window, 19937);
-    atpt::BadNoise& bad_noise = panels.createPanel<atpt::BadNoise>(window);
-    atpt::ConwayCA& conway_ca = panels.createPanel<atpt::ConwayCA>(window, 19937);
+    atpt::Noise&      noise     = panels.createPanel<atpt::Noise>(window, 19937);
+    atpt::BadNoise&   bad_noise = panels.createPanel<atpt::BadNoise>(window);
+    atpt::ConwayCA&   conway_ca = panels.createPanel<atpt::ConwayCA>(window, 19937);
+    atpt::HashLifeCA& hash_life = panels.createPanel<atpt::HashLifeCA>(window, 19937);
+
+    // Other Life-like rules share the bit-parallel kernels, specialized at compile time
+    auto& high_life     = panels.createPanel<atpt::LifeLikeCA<atpt::HighLife>>(window, 19937);
+    auto& day_and_night = panels.createPanel<atpt::LifeLikeCA<atpt::DayAndNight>>(window, 19937);
+    auto& seeds         = panels.createPanel<atpt::LifeLikeCA<atpt::Seeds>>(window, 19937);
 
     bool running = true;
     SDL_Event event;
@@ -110,22 +134,32 @@ int main()
     // Set window title to current panel name
     SDL_SetWindowTitle(window, panels.name().c_str());
 
+    // Step the visible panels on their own thread; frames reach this thread through each panel's triple buffer
+    atpt::Simulation simulation(panels);
+
     // Main loop
     while (running) {
-        bool resized = false;
-
-        // Handle events
+        // Handle events (the simulation is paused while a panel reacts)
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) running = false;
+            auto lock = simulation.pause();
             panels.event(event);
         }
 
-        // Draw active panel
+        // A window drag fires many resize events per frame; resize the panels once
+        if (panels.resizePending()) {
+            auto lock = simulation.pause();
+            panels.fitWindow();
+        }
+
+        // Present the newest finished frame of every visible panel in one bgfx frame
         panels.draw();
     }
 
     // Cleanup
+    simulation.stop();
     panels.destroy();
+    atpt::ShaderCache::shared().clear();
     bgfx::shutdown();
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -3,13 +3,18 @@
 
 namespace atpt{
 
-    Noise::Noise (SDL_Window* wd_, uint32_t seed_)
-        : Panel    ( "Noise", wd_, "shaders/fs_texture.bin" )
-        , _uh      ( bgfx::createUniform("u_tex0", bgfx::UniformType::Sampler) )
-        , _th      ( bgfx::createTexture2D(static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), false, 1, bgfx::TextureFormat::BGRA8, 0) )
-        , _pixels  ( _width * _height )
-        , _seed    { seed_ }
-        , _mt      ( _seed )
+    Noise::Noise (SDL_Window* wd_, uint32_t seed_, RandomEngine engine_)
+        : Panel       ( "Noise", wd_, "shaders/fs_palette.bin" )
+        , _sh         ( BGFX_INVALID_HANDLE )
+        , _texture    ( "u_tex0", bgfx::TextureFormat::R8 )
+        , _states     ( 0, 0 )
+        , _frames     ( )
+        , _palette    { 0xFF000000u, 0xFF13A00Eu }
+        , _engine     { engine_ }
+        , _generation { 0 }
+        , _seed       { seed_ }
+        , _mt         ( _seed )
+        , _xs         ( _seed )
     {
         return;
     }
@@ -18,46 +23,90 @@ namespace atpt{
     auto Noise::_resize (int o_width_, int o_height_)
         -> int
     {
-        _pixels.assign( static_cast<size_t>(this->_width) * static_cast<size_t>(this->_height), 0);
-       
-        if (bgfx::isValid(_th)) bgfx::destroy(_th);
-        _th = bgfx::createTexture2D(static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), false, 1, bgfx::TextureFormat::BGRA8, 0); 
+        _states.resize(((_width + 63) / 64) * 8, _height);
+        _texture.resize(_states.width(), _states.height());
         
         return 0;
     }
 
 
-    auto Noise::_draw (void)
+    auto Noise::_activate (void)
         -> int
     {
-        for (size_t i = 0; i < _pixels.size(); ++i) {
-            _pixels[i] = (_mt() & 1) ? 0xFF13A00Eu : 0xFF000000u;
+        _states.resize(((_width + 63) / 64) * 8, _height);
+        _texture.resize(_states.width(), _states.height());
+
+        _sh = bgfx::createUniform("u_state", bgfx::UniformType::Vec4);
+
+        return 0;
+    }
+
+
+    auto Noise::_step (bool publish_, int count_)
+        -> int
+    {
+        // 各フレームは前のフレームと無関係なので, 表示しない世代は作らずに数えるだけ
+        if (not publish_) {
+            _generation += count_;
+            return 0;
         }
+        _generation += count_ - 1;
+
+        // 行は 8バイト単位で詰まっているので, フレーム全体を 1本のワード列として埋められる
+        StateFrame& f = _frames.back();
+        f.width  = ((_width + 63) / 64) * 8;
+        f.height = _height;
+        f.pixels.resize(static_cast<size_t>(f.width) * f.height);
 
-        // pixels → GPUに転送
-        const bgfx::Memory* mem = bgfx::copy(
-            _pixels.data(), (uint32_t)(_pixels.size() * sizeof(uint32_t))
-        );
-        bgfx::updateTexture2D(_th, 0, 0, 0, 0, static_cast<uint16_t>(_width), static_cast<uint16_t>(_height), mem);
+        const size_t words = f.pixels.size() / 8;
+        if (_engine == RandomEngine::MT19937) fillRandom(_mt, f.pixels.data(), words);
+        else                                  fillRandom(_xs, f.pixels.data(), words);
 
-        bgfx::setTexture(0, _uh, _th);
+        f.generation = ++_generation;
+        _frames.publish();
+
+        return 0;
+    }
+
+
+    auto Noise::_present (void)
+        -> int
+    {
+        // pixels → GPUに転送 (コピーせず参照で渡す). 見えている範囲だけ
+        if (_frames.update() or _moved) _states.uploadFrame(_frames.front(), 0, _texture.handle(), _visibleTexels(8));
+
+        const float state[4] = { static_cast<float>(_width), 1.0f, 0.0f, static_cast<float>(_height) };
+        _texture.bind(0);
+        bgfx::setUniform(_sh, state);
+        _palette.bind(1);
         
         return 0;
     }
 
 
-    auto Noise::_event (const SDL_Event&)
+    // G キーで乱数エンジンを切り替える (どちらも種から作り直すので再現できる)
+    auto Noise::_event (const SDL_Event& e_)
         -> int
     {
+        if (e_.type == SDL_KEYDOWN and e_.key.keysym.sym == SDLK_g) {
+            _engine = _engine == RandomEngine::MT19937 ? RandomEngine::Xoshiro : RandomEngine::MT19937;
+            _mt.seed(_seed);
+            _xs.seed(_seed);
+        }
         return 0;
     }
 
 
-    auto Noise::_destroy (void)
+    // フレームは毎回全面を作り直すので, 置き場ごと手放してよい
+    auto Noise::_deactivate (void)
         -> int
     {
-        if (bgfx::isValid(_th)) bgfx::destroy(_th);
-        if (bgfx::isValid(_uh)) bgfx::destroy(_uh);
+        if (bgfx::isValid(_sh)) bgfx::destroy(_sh);
+        _sh = BGFX_INVALID_HANDLE;
+        _texture.destroy();
+        _palette.destroy();
+        _frames.reset();
+        _states.release();
         
         return 0;
     }
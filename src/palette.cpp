@@ -0,0 +1,62 @@
+#include <palette.hpp>
+#include <algorithm>
+
+namespace atpt{
+
+    // 与えなかった番号は黒にしておく. テクスチャは最初の bind() まで作らない
+    Palette::Palette (std::initializer_list<uint32_t> colors_)
+        : _colors { }
+        , _th     ( BGFX_INVALID_HANDLE )
+        , _uh     ( BGFX_INVALID_HANDLE )
+        , _dirty  { true }
+    {
+        assign(colors_);
+
+        return;
+    }
+
+
+    auto Palette::set (size_t i_, uint32_t color_)
+        -> void
+    {
+        _colors[i_] = color_;
+        _dirty      = true;
+    }
+
+
+    auto Palette::assign (std::initializer_list<uint32_t> colors_)
+        -> void
+    {
+        _colors.fill(0xFF000000u);
+        std::copy_n(colors_.begin(), std::min(colors_.size(), _colors.size()), _colors.begin());
+        _dirty = true;
+    }
+
+
+    // 変わっていれば転送し直してから stage_ に貼る
+    auto Palette::bind (uint8_t stage_)
+        -> void
+    {
+        if (not bgfx::isValid(_th)) {
+            _th    = bgfx::createTexture2D(256, 1, false, 1, bgfx::TextureFormat::BGRA8, BGFX_SAMPLER_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+            _uh    = bgfx::createUniform("u_palette", bgfx::UniformType::Sampler);
+            _dirty = true;
+        }
+        if (_dirty) {
+            bgfx::updateTexture2D(_th, 0, 0, 0, 0, 256, 1, bgfx::copy(_colors.data(), sizeof(_colors)));
+            _dirty = false;
+        }
+        bgfx::setTexture(stage_, _uh, _th);
+    }
+
+
+    // 色は残すので, 次の bind() で作り直せる
+    auto Palette::destroy (void)
+        -> void
+    {
+        if (bgfx::isValid(_th)) bgfx::destroy(_th);
+        if (bgfx::isValid(_uh)) bgfx::destroy(_uh);
+        _th = BGFX_INVALID_HANDLE;
+        _uh = BGFX_INVALID_HANDLE;
+    }
+}
@@ -1,6 +1,8 @@
 #include <panel.hpp>
+#include <shader_cache.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
-#include <fstream>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_syswm.h>
 #include <bgfx/bgfx.h>
@@ -8,6 +10,18 @@
 
 namespace atpt{
 
+    //+    Static Variable    +//
+    uint32_t Panel::_reset_flags = BGFX_RESET_VSYNC;
+
+
+    //+    Static Function    +//
+    auto Panel::setResetFlags (uint32_t flags_)
+        -> void
+    {
+        _reset_flags = flags_;
+    }
+
+
     //+    Member Function    +//
     auto Panel::_getWidthFromWindowHandle (void)
         -> int
@@ -26,158 +40,282 @@ namespace atpt{
     }
 
     //_ Consructor
+    // bgfx の資源はここでは作らず, 最初の activate() で作る. place() されるまでは窓全体に 1セル 1画素で描くものとする
     Panel::Panel (const std::string& name_, SDL_Window* wdh_, const std::filesystem::path& fs_path_)
         : _name          { name_ }
         , _wh            { wdh_}
+        , _fs_path       { fs_path_ }
         , _width         { _getWidthFromWindowHandle() }
         , _height        { _getHeightFromWindowHandle() } 
-        , _ph            { }
-        , _vbh           { }
-        , _ibh           { }    
-    {
-        bgfx::setViewClear(0, BGFX_CLEAR_COLOR, 0xff0000ff);
-        bgfx::setViewMode(0, bgfx::ViewMode::Sequential);
-        bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(_width), static_cast<uint16_t>(_height));
-
-
-        // Vertex Shader
-        _vsh = BGFX_INVALID_HANDLE;
-        {
-            std::ifstream ifs("shaders/vs_fullscreen.bin", std::ios::binary);
-            if (!ifs) {
-                std::cerr << "Failed to load shader: shaders/vs_fullscreen.bin\n";
-                bgfx::shutdown(); SDL_DestroyWindow(wdh_); SDL_Quit();
-            }
-        
-            std::vector<char> data((std::istreambuf_iterator<char>(ifs)),
-                                   std::istreambuf_iterator<char>());
-            const bgfx::Memory* mem = bgfx::copy(data.data(), (uint32_t)data.size());
-            _vsh = bgfx::createShader(mem);
-            if (!bgfx::isValid(_vsh)) {
-                std::cerr << "Failed to create vertex shader.\n";
-                bgfx::shutdown(); SDL_DestroyWindow(wdh_); SDL_Quit();
-            }
-        }
+        , _view          { 0 }
+        , _x             { 0 }
+        , _y             { 0 }
+        , _view_width    { _width }
+        , _view_height   { _height }
+        , _cell_size     { 1 }
+        , _grid_width    { 0 }
+        , _grid_height   { 0 }
+        , _cam_x         { _width  / 2.0 }
+        , _cam_y         { _height / 2.0 }
+        , _zoom          { 1.0 }
+        , _visible       { 0, 0, _width, _height }
+        , _moved         { true }
+        , _ph            ( BGFX_INVALID_HANDLE )
+        , _vh            ( BGFX_INVALID_HANDLE )
+        , _pixels        ( _width, _height )
+        , _deadline      ( clock::time_point::max() )
+        , _active        { false }
+    {
+        return;   
+    }
 
-        // Fragment Shader
-        _fsh = BGFX_INVALID_HANDLE;
-        {
-            std::ifstream ifs(fs_path_, std::ios::binary);
-            if (!ifs) {
-                std::cerr << "Failed to load shader: shaders/fs_texture.bin\n";
-                if (bgfx::isValid(_fsh)) bgfx::destroy(_fsh);
-                bgfx::shutdown(); SDL_DestroyWindow(wdh_); SDL_Quit();
-            }
-        
-            std::vector<char> data((std::istreambuf_iterator<char>(ifs)),
-                                   std::istreambuf_iterator<char>());
-            const bgfx::Memory* mem = bgfx::copy(data.data(), (uint32_t)data.size());
-            _fsh = bgfx::createShader(mem);
-            if (!bgfx::isValid(_fsh)) {
-                std::cerr << "Failed to create fragment shader.\n";
-                if (bgfx::isValid(_fsh)) bgfx::destroy(_fsh);
-                bgfx::shutdown(); SDL_DestroyWindow(wdh_); SDL_Quit();
+
+    //_ Inner Function
+    auto Panel::_setupView (void)
+        -> void
+    {
+        bgfx::setViewClear(_view, BGFX_CLEAR_COLOR, 0xff0000ff);
+        bgfx::setViewMode(_view, bgfx::ViewMode::Sequential);
+        bgfx::setViewRect(_view, static_cast<uint16_t>(_x), static_cast<uint16_t>(_y), static_cast<uint16_t>(_view_width), static_cast<uint16_t>(_view_height));
+    }
+
+
+    // シミュレーションの大きさを決め直す. 表示中で変われば _resize で合わせる.
+    // 大きさを決めてあれば (setGridSize) 窓の大きさが変わっても世界はそのまま
+    auto Panel::_refit (void)
+        -> int
+    {
+        const int old_width  = _width;
+        const int old_height = _height;
+
+        _width  = _grid_width  > 0 ? _grid_width  : std::max(_view_width  / _cell_size, 1);
+        _height = _grid_height > 0 ? _grid_height : std::max(_view_height / _cell_size, 1);
+
+        if (old_width != _width or old_height != _height) {
+            _cam_x = _width  / 2.0;
+            _cam_y = _height / 2.0;
+            _moved = true;
+            if (_active) {
+                _pixels.resize(_width, _height);
+                if (int ret = this->_resize(old_width, old_height)) {
+                    std::cerr << "reize error" << std::endl;
+                    return ret;
+                }
             }
         }
 
-        // Make Program
-        _ph = bgfx::createProgram(_vsh, _fsh, true);
-        if (!bgfx::isValid(_ph)) {
-            std::cerr << "Failed to link shader program.\n";
-            if (bgfx::isValid(_vsh)) bgfx::destroy(_vsh);
-            if (bgfx::isValid(_fsh)) bgfx::destroy(_fsh);
-            bgfx::shutdown(); SDL_DestroyWindow(wdh_); SDL_Quit();
-        }
+        _look();
+        return 0;
+    }
+
+
+    // 倍率を収まる範囲に戻し, 見えているセルの範囲 (_visible) を求め直す.
+    // 縮小はグリッド全体が収まるところまで. 端をまたぐ向きは (周期的につながるので) 全体を見えているものとする
+    auto Panel::_look (void)
+        -> void
+    {
+        const double fit = std::min(static_cast<double>(_view_width) / _width, static_cast<double>(_view_height) / _height);
+        const double lo  = std::min(static_cast<double>(_cell_size), fit);
+        _zoom = std::clamp(_zoom, lo, std::max(lo, max_zoom));
 
-        // フルスクリーン四角形
-        bgfx::VertexLayout layout;
-        layout.begin()
-            .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
-            .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
-        .end();
-
-        const struct{float x, y, z, u, v; } quadVerts[] = {
-            {-1.f,-1.f,0.f, 0.f,1.f},
-            { 1.f,-1.f,0.f, 1.f,1.f},
-            { 1.f, 1.f,0.f, 1.f,0.f},
-            {-1.f, 1.f,0.f, 0.f,0.f},
+        const auto span = [](double center_, double half_, int n_, int& o_, int& w_){
+            const long long a = static_cast<long long>(std::floor(center_ - half_));
+            const long long b = static_cast<long long>(std::ceil (center_ + half_));
+            const long long m = ((a % n_) + n_) % n_;
+            if (b - a >= n_ or m + (b - a) > n_) return;
+            o_ = static_cast<int>(m);
+            w_ = static_cast<int>(b - a);
         };
-        const uint16_t quadIdx[] = { 0,1,2, 0,2,3 };
 
-        _vbh = bgfx::createVertexBuffer(
-            bgfx::copy(quadVerts, sizeof(quadVerts)), layout);
-        _ibh = bgfx::createIndexBuffer(
-            bgfx::copy(quadIdx, sizeof(quadIdx)));
+        PixelRect v{ 0, 0, _width, _height };
+        span(_cam_x, _view_width  / (2.0 * _zoom), _width,  v.x, v.w);
+        span(_cam_y, _view_height / (2.0 * _zoom), _height, v.y, v.h);
 
-        return;   
+        if (v != _visible) {
+            _visible = v;
+            _moved   = true;
+        }
+    }
+
+
+    // 矩形の中の (x_, y_) 画素の下にあるセルを動かさずに factor_ 倍する. セルの行 0 は下端に描かれる
+    auto Panel::_zoomAt (double factor_, int x_, int y_)
+        -> void
+    {
+        const double cx = _cam_x + (x_ - _view_width  / 2.0) / _zoom;
+        const double cy = _cam_y - (y_ - _view_height / 2.0) / _zoom;
+
+        _zoom *= factor_;
+        _look();
+        _cam_x = cx - (x_ - _view_width  / 2.0) / _zoom;
+        _cam_y = cy + (y_ - _view_height / 2.0) / _zoom;
+        _look();
     }
 
 
     //_ Variable Function
+    // budget_ (秒) が 0 以下なら区切らずに count_ 世代を進め切る
+    auto Panel::step (bool publish_, double budget_, int count_)
+        -> int
+    {
+        _deadline = budget_ > 0.0 ? clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(budget_)) : clock::time_point::max();
+        return _step(publish_, std::max(count_, 1));
+    }
+
+
+    // 自分の view に積むだけ. bgfx::frame() は PanelSet::draw が全パネルぶんまとめて 1回呼ぶ
     auto Panel::draw (void)
         -> int
     {
-        bgfx::touch(0);
+        if (not _active) return 0;
+
+        bgfx::touch(_view);
     
-        if (int ret = this->_draw()) {
+        if (int ret = this->_present()) {
             std::cerr << "setPixcels error " << std::endl;
             return ret;
         }
+        _moved = false;
 
-        bgfx::setVertexBuffer(0, _vbh);
-        bgfx::setIndexBuffer(_ibh);
-        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-        bgfx::submit(0, _ph);
+        // 見えている範囲をグリッド全体を 0-1 とした座標で渡す. セル 1つが何画素になるかはシェーダが点サンプリングで拡げる
+        const double half_w = _view_width  / (2.0 * _zoom);
+        const double half_h = _view_height / (2.0 * _zoom);
+        const float  view[4] = {
+            static_cast<float>((_cam_x - half_w) / _width), static_cast<float>((_cam_y - half_h) / _height),
+            static_cast<float>(2.0 * half_w / _width),      static_cast<float>(2.0 * half_h / _height)
+        };
+        bgfx::setUniform(_vh, view);
 
-        bgfx::frame();
+        // 頂点バッファなしで 3頂点を流す. 位置と UV は vs_fullscreen.sc が gl_VertexID から作る (画面を覆う 1枚の三角形)
+        bgfx::setVertexCount(3);
+        bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+        bgfx::submit(_view, _ph);
 
         return 0;
     }
     
    
+    // 窓の大きさの変化は PanelSet が受けて place() で伝える. 表示の拡大と移動はここで受け, 他はパネルに渡す
     auto Panel::event (const SDL_Event& e_)
         -> int
     {
-        if (e_.type == SDL_WINDOWEVENT and
-            (
-                e_.window.event == SDL_WINDOWEVENT_RESIZED or
-                e_.window.event == SDL_WINDOWEVENT_SIZE_CHANGED
-            )
-        )
-        {
-            int old_width   = _width;
-            int old_height  = _height;
-           
-            _width =  _getWidthFromWindowHandle();
-            _height = _getHeightFromWindowHandle();
-            
-            bgfx::reset(static_cast<uint32_t>(_width), static_cast<uint32_t>(_height), BGFX_RESET_VSYNC);
-            bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(_width), static_cast<uint16_t>(_height));
-
-            if (int ret = this->_resize(old_width, old_height)) {
-                std::cerr << "reize error" << std::endl;
-                return ret;
-            }
-        }else{
-            if (int ret = this->_event(e_)){
-                std::cerr << "event error" << std::endl;
-                return ret;
-            };
+        switch (e_.type) {
+            case SDL_MOUSEWHEEL:
+                if (e_.wheel.y != 0) {
+                    int mx = 0, my = 0;
+                    SDL_GetMouseState(&mx, &my);
+                    _zoomAt(std::exp2(static_cast<double>(e_.wheel.y)), mx - _x, my - _y);
+                }
+                break;
+            case SDL_MOUSEMOTION:
+                if (e_.motion.state & SDL_BUTTON_LMASK) {
+                    _cam_x -= e_.motion.xrel / _zoom;
+                    _cam_y += e_.motion.yrel / _zoom;
+                    _look();
+                }
+                break;
+            case SDL_KEYDOWN:
+                if (e_.key.keysym.sym == SDLK_HOME) {
+                    _zoom  = _cell_size;
+                    _cam_x = _width  / 2.0;
+                    _cam_y = _height / 2.0;
+                    _look();
+                }
+                break;
+            default:
+                break;
         }
 
+        if (int ret = this->_event(e_)){
+            std::cerr << "event error" << std::endl;
+            return ret;
+        };
+
         return 0;
     }
+
+
+    // 窓の中の (x_, y_, w_, h_) を view_ で描く. 大きさが変わればシミュレーションの大きさも決め直す
+    auto Panel::place (bgfx::ViewId view_, int x_, int y_, int w_, int h_)
+        -> int
+    {
+        _view        = view_;
+        _x           = x_;
+        _y           = y_;
+        _view_width  = w_;
+        _view_height = h_;
+        if (_active) _setupView();
+
+        return _refit();
+    }
+
+
+    // 1セルを窓の何画素で描くか. 大きさを決めていなければシミュレーションの大きさも変わる
+    auto Panel::setCellSize (int cell_size_)
+        -> int
+    {
+        _cell_size = std::max(cell_size_, 1);
+        _zoom      = _cell_size;
+        return _refit();
+    }
+
+
+    // シミュレーションの大きさ (セル) を窓と切り離して決める. 0 なら窓 (の矩形) に合わせる
+    auto Panel::setGridSize (int width_, int height_)
+        -> int
+    {
+        _grid_width  = std::max(width_,  0);
+        _grid_height = std::max(height_, 0);
+        return _refit();
+    }
+
     
-    auto Panel::destroy (void)
+    // 休んでいる間に place() で大きさが変わっていてもよいように, _activate は今の大きさで作る
+    auto Panel::activate (void)
         -> int
     {
-        this->_destroy();
-        if (bgfx::isValid(_ibh)) bgfx::destroy(_ibh);
-        if (bgfx::isValid(_vbh)) bgfx::destroy(_vbh);
-        if (bgfx::isValid(_fsh)) bgfx::destroy(_fsh);
-        if (bgfx::isValid(_vsh)) bgfx::destroy(_vsh);
-        if (bgfx::isValid(_ph))  bgfx::destroy(_ph);   
-        
+        if (_active) return 0;
+
+        _pixels.resize(_width, _height);
+        _setupView();
+
+        // プログラムは同じシェーダの組どうしで共有する (ファイルを読むのもリンクするのも最初の 1回だけ)
+        _ph = ShaderCache::shared().program("shaders/vs_fullscreen.bin", _fs_path);
+        if (!bgfx::isValid(_ph)) return 1;
+        _vh    = bgfx::createUniform("u_view", bgfx::UniformType::Vec4);
+        _moved = true;
+
+        if (int ret = this->_activate()) {
+            std::cerr << "activate error" << std::endl;
+            return ret;
+        }
+
+        _active = true;
         return 0;
     }
+
+
+    // シミュレーションの状態は残し, 作り直せるもの (GPU の資源, 転送用の置き場) を手放す
+    auto Panel::deactivate (void)
+        -> int
+    {
+        if (not _active) return 0;
+
+        this->_deactivate();
+        _pixels.release();
+        if (bgfx::isValid(_vh)) bgfx::destroy(_vh);
+        _vh = BGFX_INVALID_HANDLE;
+        // プログラムは ShaderCache のものなので消さない
+        _ph = BGFX_INVALID_HANDLE;
+
+        _active = false;
+        return 0;
+    }
+
+
+    auto Panel::destroy (void)
+        -> int
+    {
+        return deactivate();
+    }
 }
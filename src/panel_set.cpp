@@ -1,49 +1,302 @@
 #include <panel_set.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <SDL2/SDL.h>
 
 namespace atpt{
 
     //+    Member Function    +//
     //_ Constructor
     PanelSet::PanelSet (SDL_Window* wh_)
-        : _panels   ( )
-        , _panel_id (0)
-        , _wh       (wh_)
+        : _panels         ( )
+        , _panel_id       (0)
+        , _wh             (wh_)
+        , _rate           (60.0)
+        , _max_backlog    (8)
+        , _max_block      (8)
+        , _step_budget    (0.004)
+        , _vsync          (true)
+        , _presented      (0)
+        , _tiled          (false)
+        , _tile_cols      (3)
+        , _tile_rows      (3)
+        , _visible        ( )
+        , _status         ( )
+        , _cell_size      (1)
+        , _grid_width     (0)
+        , _grid_height    (0)
+        , _resize_pending (false)
     {
         return;
     }
 
 
+    //_ Setter
+    auto PanelSet::setRate (double rate_) -> void
+    {
+        _rate = std::max(rate_, 0.0);
+    }
+
+
+    auto PanelSet::setMaxBacklog (int n_) -> void
+    {
+        _max_backlog = std::max(n_, 1);
+    }
+
+
+    auto PanelSet::setMaxBlock (int n_) -> void
+    {
+        _max_block = std::max(n_, 1);
+    }
+
+
+    auto PanelSet::setStepBudget (double seconds_) -> void
+    {
+        _step_budget = std::max(seconds_, 0.0);
+    }
+
+
+    // 描画スレッドから呼ぶこと (bgfx::reset)
+    auto PanelSet::setVsync (bool vsync_) -> void
+    {
+        _vsync = vsync_;
+        Panel::setResetFlags(_vsync ? BGFX_RESET_VSYNC : BGFX_RESET_NONE);
+
+        int width = 0, height = 0;
+        SDL_GetWindowSize(_wh, &width, &height);
+        bgfx::reset(static_cast<uint32_t>(width), static_cast<uint32_t>(height), Panel::resetFlags());
+    }
+
+
+    auto PanelSet::setTiled (bool tiled_) -> int
+    {
+        _tiled = tiled_;
+        return _layout();
+    }
+
+
+    auto PanelSet::setTiling (int cols_, int rows_) -> int
+    {
+        _tile_cols = std::clamp(cols_, 1, 8);
+        _tile_rows = std::clamp(rows_, 1, 8);
+        return _layout();
+    }
+
+
+    auto PanelSet::setCellSize (int cell_size_) -> int
+    {
+        _cell_size = std::max(cell_size_, 1);
+
+        int ret = 0;
+        for(PanelPtr& p : _panels){
+            if (int r = p->setCellSize(_cell_size)) ret = r;
+        }
+        return ret;
+    }
+
+
+    auto PanelSet::setGridSize (int width_, int height_) -> int
+    {
+        _grid_width  = std::max(width_,  0);
+        _grid_height = std::max(height_, 0);
+
+        int ret = 0;
+        for(PanelPtr& p : _panels){
+            if (int r = p->setGridSize(_grid_width, _grid_height)) ret = r;
+        }
+        return ret;
+    }
+
+
+    // 窓の大きさの変化をまとめて 1回だけ反映する. ドラッグ中は 1フレームに何度もイベントが届くので,
+    // 毎回グリッドやテクスチャを作り直さないよう, 描画の前に (シミュレーションを止めて) 1回呼ぶ
+    auto PanelSet::fitWindow (void) -> int
+    {
+        if (not _resize_pending) return 0;
+        _resize_pending = false;
+
+        int width = 0, height = 0;
+        SDL_GetWindowSize(_wh, &width, &height);
+        bgfx::reset(static_cast<uint32_t>(width), static_cast<uint32_t>(height), Panel::resetFlags());
+        return _layout();
+    }
+
+
+    //_ Inner Function
+    // 表示するパネルを決めて窓を cols x rows に割る. 見えなくなるパネルが先に手放してから, 新しく見えるパネルが作る.
+    // view 0 は窓全体の背景 (空いたマス) で, パネルは 1 から順に使う
+    auto PanelSet::_layout (void) -> int
+    {
+        if (_panels.empty()) return 0;
+
+        int width = 0, height = 0;
+        SDL_GetWindowSize(_wh, &width, &height);
+
+        const int    cols = _tiled ? _tile_cols : 1;
+        const int    rows = _tiled ? _tile_rows : 1;
+        const size_t n    = std::min(_panels.size(), static_cast<size_t>(cols) * rows);
+
+        std::vector<size_t> next;
+        for(size_t k = 0; k < n; ++k) next.push_back((_panel_id + k) % _panels.size());
+
+        for(size_t id : _visible){
+            if (std::find(next.begin(), next.end(), id) == next.end()) _panels.at(id)->deactivate();
+        }
+
+        bgfx::setViewClear(0, BGFX_CLEAR_COLOR, 0x000000ff);
+        bgfx::setViewRect(0, 0, 0, static_cast<uint16_t>(width), static_cast<uint16_t>(height));
+
+        int ret = 0;
+        for(size_t k = 0; k < n; ++k){
+            const int c  = static_cast<int>(k) % cols;
+            const int r  = static_cast<int>(k) / cols;
+            const int x0 = width  *  c      / cols;
+            const int x1 = width  * (c + 1) / cols;
+            const int y0 = height *  r      / rows;
+            const int y1 = height * (r + 1) / rows;
+
+            Panel& p = *_panels.at(next[k]);
+            if (int r_ = p.place(static_cast<bgfx::ViewId>(k + 1), x0, y0, x1 - x0, y1 - y0)) ret = r_;
+            if (int r_ = p.activate())                                                           ret = r_;
+        }
+
+        // 世代の途中で返したパネルが見えたままなら, その印を残す. 消すと Simulation が続きのつもりで呼ぶ step() で
+        // 済んだパネルまでもう一度進んでしまう (大きさが変わって途中の世代を捨てたパネルは, 続きとして 1から進め直す)
+        std::vector<int> status(next.size(), 0);
+        for(size_t k = 0; k < next.size(); ++k){
+            const auto it = std::find(_visible.begin(), _visible.end(), next[k]);
+            if (it != _visible.end()) status[k] = _status[static_cast<size_t>(it - _visible.begin())] == Panel::yielded ? Panel::yielded : 0;
+        }
+
+        _visible = std::move(next);
+        _status  = std::move(status);
+        SDL_SetWindowTitle(_wh, name().c_str());
+
+        return ret;
+    }
+
+
+    // 窓の (x_, y_) 画素に描かれているパネル. なければ nullptr
+    auto PanelSet::_panelAt (int x_, int y_) -> Panel*
+    {
+        for(size_t id : _visible){
+            Panel& p = *_panels[id];
+            if (x_ >= p.x() and x_ < p.x() + p.viewWidth() and y_ >= p.y() and y_ < p.y() + p.viewHeight()) return &p;
+        }
+        return nullptr;
+    }
+
+
     //_ Variable Function
+    // 表示中のパネルを count_ 世代ずつ同時に進める. 持ち時間で途中になった (yielded) パネルがあれば,
+    // 次の呼び出しではそれだけを続けるので, どのパネルも同じ世代数だけ進む
+    auto PanelSet::step (bool publish_, int count_) -> int
+    {
+        const bool resume = std::find(_status.begin(), _status.end(), Panel::yielded) != _status.end();
+
+        ThreadPool::shared().parallelFor(0, static_cast<int>(_visible.size()), 1, [&](int k0_, int k1_){
+            for(int k = k0_; k < k1_; ++k){
+                if (resume and _status[k] != Panel::yielded) continue;
+                _status[k] = _panels[_visible[k]]->step(publish_, _step_budget, count_);
+            }
+        });
+
+        int ret = 0;
+        for(int s : _status){
+            if (s == Panel::yielded) return Panel::yielded;
+            if (s != 0)              ret = s;
+        }
+        return ret;
+    }
+
+
+    // 全パネルを積んでから 1回だけフレームを進める
     auto PanelSet::draw (void) -> int
     {
-        return _panels.at(_panel_id)->draw();        
+        int ret = 0;
+        bgfx::touch(0);
+        for(size_t id : _visible){
+            if (int r = _panels[id]->draw()) ret = r;
+        }
+        bgfx::frame();
+
+        _presented.fetch_add(1, std::memory_order_release);
+        return ret;
     }
 
 
     auto PanelSet::event (const SDL_Event& e_) -> int
     {
+        // 大きさの変化は印を付けるだけで, fitWindow() がまとめて反映する
+        if (e_.type == SDL_WINDOWEVENT and (e_.window.event == SDL_WINDOWEVENT_RESIZED or e_.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)) {
+            _resize_pending = true;
+            return 1;
+        }
+
         if (e_.type == SDL_KEYDOWN) {
             switch (e_.key.keysym.sym) {
                 case SDLK_UP:
-                    if (_panel_id == _panels.size() - 1)   _panel_id = 0;
-                    else                                 ++_panel_id;
-                    SDL_SetWindowTitle(_wh, name().c_str());
+                    select(_panel_id == _panels.size() - 1 ? 0 : _panel_id + 1);
                     return 1;
 
                 case SDLK_DOWN:
-                    if (_panel_id == 0)   _panel_id = _panels.size() - 1;
-                    else                --_panel_id;
-                    SDL_SetWindowTitle(_wh, name().c_str());
+                    select(_panel_id == 0 ? _panels.size() - 1 : _panel_id - 1);
+                    return 1;
+
+                case SDLK_PLUS:
+                case SDLK_EQUALS:
+                case SDLK_KP_PLUS:
+                    setRate(_rate == 0.0 ? 60.0 : std::min(_rate * 2.0, 1.0e6));
+                    return 1;
+
+                case SDLK_MINUS:
+                case SDLK_KP_MINUS:
+                    setRate(_rate == 0.0 ? 60.0 : std::max(_rate / 2.0, 0.25));
+                    return 1;
+
+                case SDLK_0:
+                    setRate(0.0);
+                    return 1;
+
+                case SDLK_v:
+                    setVsync(not _vsync);
+                    return 1;
+
+                case SDLK_t:
+                    setTiled(not _tiled);
                     return 1;
             }
         }
 
+        if (e_.type == SDL_MOUSEWHEEL or e_.type == SDL_MOUSEMOTION) {
+            int x = 0, y = 0;
+            if (e_.type == SDL_MOUSEMOTION) { x = e_.motion.x; y = e_.motion.y; }
+            else                            SDL_GetMouseState(&x, &y);
+
+            Panel* p = _panelAt(x, y);
+            return p ? p->event(e_) : 0;
+        }
+
         return _panels.at(_panel_id)->event(e_);
     }
 
 
+    // tiled では並びの先頭が id_ になるようにずらす
+    auto PanelSet::select (size_t id_) -> int
+    {
+        if (id_ == _panel_id) return 0;
+
+        _panel_id = id_;
+        return _layout();
+    }
+
+
     auto PanelSet::destroy (void) -> int
     {
-        return _panels.at(_panel_id)->destroy();
+        int ret = 0;
+        for(PanelPtr& p : _panels){
+            if (int r = p->destroy()) ret = r;
+        }
+        return ret;
     }
 }
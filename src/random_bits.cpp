@@ -0,0 +1,273 @@
+#include <random_bits.hpp>
+#include <bit_grid.hpp>
+#include <cpu_features.hpp>
+#include <thread_pool.hpp>
+#include <cstring>
+
+#if ATPT_X86
+    #include <immintrin.h>
+#endif
+
+namespace atpt{
+
+    namespace{
+
+        constexpr auto rotl (uint64_t x_, int k_) -> uint64_t { return (x_ << k_) | (x_ >> (64 - k_)); }
+
+        auto splitmix64 (uint64_t& x_) -> uint64_t
+        {
+            uint64_t z = (x_ += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        const bool _has_avx2 = detectSimdLevel() >= SimdLevel::AVX2;
+    }
+
+
+    //+   Member Function    +//
+    //_ Constructor
+    Xoshiro256x4::Xoshiro256x4 (uint64_t seed_)
+        : _s { }
+    {
+        seed(seed_);
+
+        return;
+    }
+
+
+    //_ Inner Function
+    auto Xoshiro256x4::_fillScalar (unsigned char* out_, size_t n_)
+        -> void
+    {
+        for(size_t j = 0; j < n_; ++j){
+            const size_t l = j & 3;
+            const uint64_t r = rotl(_s[0][l] + _s[3][l], 23) + _s[0][l];
+            const uint64_t t = _s[1][l] << 17;
+            _s[2][l] ^= _s[0][l];
+            _s[3][l] ^= _s[1][l];
+            _s[1][l] ^= _s[2][l];
+            _s[0][l] ^= _s[3][l];
+            _s[2][l] ^= t;
+            _s[3][l]  = rotl(_s[3][l], 45);
+            std::memcpy(out_ + j * sizeof(uint64_t), &r, sizeof(r));
+        }
+    }
+
+
+#if ATPT_X86
+    // 4ワードずつ. 余りはスカラで続ける (レーンの順番は変わらない)
+    ATPT_TARGET("avx2")
+    auto Xoshiro256x4::_fillAVX2 (unsigned char* out_, size_t n_)
+        -> void
+    {
+        __m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_s[0]));
+        __m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_s[1]));
+        __m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_s[2]));
+        __m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(_s[3]));
+
+        size_t j = 0;
+        for(; j + 4 <= n_; j += 4){
+            const __m256i sum = _mm256_add_epi64(s0, s3);
+            const __m256i r   = _mm256_add_epi64(_mm256_or_si256(_mm256_slli_epi64(sum, 23), _mm256_srli_epi64(sum, 41)), s0);
+            const __m256i t   = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_ + j * sizeof(uint64_t)), r);
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(_s[0]), s0);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(_s[1]), s1);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(_s[2]), s2);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(_s[3]), s3);
+
+        _fillScalar(out_ + j * sizeof(uint64_t), n_ - j);
+    }
+#else
+    auto Xoshiro256x4::_fillAVX2 (unsigned char* out_, size_t n_)
+        -> void
+    {
+        _fillScalar(out_, n_);
+    }
+#endif
+
+
+    //_ Variable Function
+    // splitmix64 で1本目を作り, 残りのレーンは jump 多項式で 2^128 ずつずらす
+    auto Xoshiro256x4::seed (uint64_t seed_)
+        -> void
+    {
+        static constexpr uint64_t jump[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+        uint64_t s[4];
+        for(uint64_t& w : s) w = splitmix64(seed_);
+
+        for(int l = 0; l < 4; ++l){
+            for(int k = 0; k < 4; ++k) _s[k][l] = s[k];
+
+            uint64_t j[4] = { 0, 0, 0, 0 };
+            for(uint64_t m : jump){
+                for(int b = 0; b < 64; ++b){
+                    if ((m >> b) & 1u) for(int k = 0; k < 4; ++k) j[k] ^= s[k];
+                    const uint64_t t = s[1] << 17;
+                    s[2] ^= s[0];
+                    s[3] ^= s[1];
+                    s[1] ^= s[2];
+                    s[0] ^= s[3];
+                    s[2] ^= t;
+                    s[3]  = rotl(s[3], 45);
+                }
+            }
+            for(int k = 0; k < 4; ++k) s[k] = j[k];
+        }
+    }
+
+
+    // 呼ぶたびにレーン 0 から使う. n_ が 4 の倍数でないときの余りもレーン 0 から順なので, SIMD でもスカラでも同じ列になる
+    auto Xoshiro256x4::fill (void* out_, size_t n_)
+        -> void
+    {
+        unsigned char* out = static_cast<unsigned char*>(out_);
+        if (_has_avx2) _fillAVX2(out, n_);
+        else           _fillScalar(out, n_);
+    }
+
+
+    //+   Function    +//
+    auto fillRandom (std::mt19937& mt_, void* out_, size_t n_)
+        -> void
+    {
+        unsigned char* out = static_cast<unsigned char*>(out_);
+        for(size_t j = 0; j < n_; ++j){
+            const uint64_t lo = mt_();
+            const uint64_t w  = lo | (static_cast<uint64_t>(mt_()) << 32);
+            std::memcpy(out + j * sizeof(uint64_t), &w, sizeof(w));
+        }
+    }
+
+
+    auto fillRandom (Xoshiro256x4& x_, void* out_, size_t n_)
+        -> void
+    {
+        x_.fill(out_, n_);
+    }
+
+
+    auto randomEngineName (RandomEngine e_)
+        -> const char*
+    {
+        switch (e_) {
+            case RandomEngine::MT19937: return "mt19937";
+            case RandomEngine::Xoshiro: return "xoshiro256++x4";
+        }
+        return "unknown";
+    }
+
+
+    namespace{
+
+        auto _fillCounterScalar (uint64_t seed_, uint64_t generation_, uint64_t index_, unsigned char* out_, size_t n_)
+            -> void
+        {
+            for(size_t j = 0; j < n_; ++j){
+                const uint64_t w = counterRandom(seed_, generation_, index_ + j);
+                std::memcpy(out_ + j * sizeof(uint64_t), &w, sizeof(w));
+            }
+        }
+
+
+#if ATPT_X86
+        // 4ブロック (8ワード) ずつ. 64bit レーンの下位 32bit に各カウンタ語を置き, _mm256_mul_epu32 で 32x32 → 64 を取る.
+        // block_ は偶数の index に対応するブロック番号
+        ATPT_TARGET("avx2")
+        auto _fillCounterAVX2 (uint64_t seed_, uint64_t generation_, uint64_t block_, unsigned char* out_, size_t blocks_)
+            -> void
+        {
+            const __m256i lo32 = _mm256_set1_epi64x(0xFFFFFFFFll);
+            const __m256i m0   = _mm256_set1_epi64x(0xD2511F53ll);
+            const __m256i m1   = _mm256_set1_epi64x(0xCD9E8D57ll);
+            const __m256i w0   = _mm256_set1_epi64x(0x9E3779B9ll);
+            const __m256i w1   = _mm256_set1_epi64x(0xBB67AE85ll);
+            const __m256i g0   = _mm256_set1_epi64x(static_cast<long long>(generation_ & 0xFFFFFFFFu));
+            const __m256i g1   = _mm256_set1_epi64x(static_cast<long long>(generation_ >> 32));
+
+            size_t j = 0;
+            for(; j + 4 <= blocks_; j += 4){
+                const uint64_t b = block_ + j;
+                const __m256i  v = _mm256_set_epi64x(static_cast<long long>(b + 3), static_cast<long long>(b + 2), static_cast<long long>(b + 1), static_cast<long long>(b));
+
+                __m256i c0 = _mm256_and_si256(v, lo32);
+                __m256i c1 = _mm256_srli_epi64(v, 32);
+                __m256i c2 = g0;
+                __m256i c3 = g1;
+                __m256i k0 = _mm256_set1_epi64x(static_cast<long long>(seed_ & 0xFFFFFFFFu));
+                __m256i k1 = _mm256_set1_epi64x(static_cast<long long>(seed_ >> 32));
+
+                for(int r = 0; r < 10; ++r){
+                    const __m256i p0 = _mm256_mul_epu32(m0, c0);
+                    const __m256i p1 = _mm256_mul_epu32(m1, c2);
+                    c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), c1), k0);
+                    c1 = _mm256_and_si256(p1, lo32);
+                    c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), c3), k1);
+                    c3 = _mm256_and_si256(p0, lo32);
+                    k0 = _mm256_and_si256(_mm256_add_epi64(k0, w0), lo32);
+                    k1 = _mm256_and_si256(_mm256_add_epi64(k1, w1), lo32);
+                }
+
+                // ブロックごとに (c0 | c1 << 32), (c2 | c3 << 32) の順に並べる
+                const __m256i e  = _mm256_or_si256(c0, _mm256_slli_epi64(c1, 32));
+                const __m256i o  = _mm256_or_si256(c2, _mm256_slli_epi64(c3, 32));
+                const __m256i lo = _mm256_unpacklo_epi64(e, o);
+                const __m256i hi = _mm256_unpackhi_epi64(e, o);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_ + (2 * j + 0) * sizeof(uint64_t)), _mm256_permute2x128_si256(lo, hi, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_ + (2 * j + 4) * sizeof(uint64_t)), _mm256_permute2x128_si256(lo, hi, 0x31));
+            }
+
+            _fillCounterScalar(seed_, generation_, (block_ + j) * 2, out_ + 2 * j * sizeof(uint64_t), (blocks_ - j) * 2);
+        }
+#endif
+    }
+
+
+    // 奇数の index_ から始まるとき, 先頭の 1ワードだけスカラで済ませてブロックの境目に揃える
+    auto fillCounterRandom (uint64_t seed_, uint64_t generation_, uint64_t index_, void* out_, size_t n_)
+        -> void
+    {
+        unsigned char* out = static_cast<unsigned char*>(out_);
+
+#if ATPT_X86
+        if (_has_avx2) {
+            if ((index_ & 1) and n_ > 0) {
+                _fillCounterScalar(seed_, generation_, index_, out, 1);
+                ++index_; out += sizeof(uint64_t); --n_;
+            }
+            _fillCounterAVX2(seed_, generation_, index_ >> 1, out, n_ / 2);
+            if (n_ & 1) _fillCounterScalar(seed_, generation_, index_ + n_ - 1, out + (n_ - 1) * sizeof(uint64_t), 1);
+            return;
+        }
+#endif
+        _fillCounterScalar(seed_, generation_, index_, out, n_);
+    }
+
+
+    auto randomizeGrid (PeriodicBoundaryBitGrid& grid_, uint64_t seed_, uint64_t generation_)
+        -> void
+    {
+        const int      words = grid_.words();
+        const uint64_t tail  = grid_.tailMask();
+
+        ThreadPool::shared().parallelBands(grid_, [&](int b0_, int b1_){
+            for(int b = b0_; b < b1_; ++b){
+                uint64_t* row = grid_.row(b);
+                fillCounterRandom(seed_, generation_, static_cast<uint64_t>(b) * words, row, static_cast<size_t>(words));
+                row[words - 1] &= tail;
+            }
+        });
+        grid_.fillHalo();
+    }
+}
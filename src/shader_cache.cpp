@@ -0,0 +1,94 @@
+#include <shader_cache.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace atpt{
+
+    //+   Static Function    +//
+    auto ShaderCache::shared (void)
+        -> ShaderCache&
+    {
+        static ShaderCache cache;
+        return cache;
+    }
+
+
+    //+   Member Function    +//
+    //_ Inner Function
+    // 埋め込みは参照で渡す (実行ファイルの中なので解放されない). ファイルはコピーして渡す
+    auto ShaderCache::_load (const std::filesystem::path& path_)
+        -> const bgfx::Memory*
+    {
+        const bgfx::RendererType::Enum renderer = bgfx::getRendererType();
+        const std::string              name     = path_.stem().string();
+
+        size_t                count    = 0;
+        const EmbeddedShader* embedded = embeddedShaders(count);
+        for(size_t i = 0; i < count; ++i){
+            if (embedded[i].renderer == renderer and name == embedded[i].name) return bgfx::makeRef(embedded[i].data, embedded[i].size);
+        }
+
+        std::ifstream ifs(path_, std::ios::binary);
+        if (!ifs) {
+            std::cerr << "Failed to load shader: " << path_.string() << "\n";
+            return nullptr;
+        }
+        std::vector<char> data((std::istreambuf_iterator<char>(ifs)),
+                               std::istreambuf_iterator<char>());
+        return bgfx::copy(data.data(), static_cast<uint32_t>(data.size()));
+    }
+
+
+    //_ Variable Function
+    auto ShaderCache::shader (const std::filesystem::path& path_)
+        -> bgfx::ShaderHandle
+    {
+        const Key key{ bgfx::getRendererType(), path_.string() };
+        if (auto it = _shaders.find(key); it != _shaders.end()) return it->second;
+
+        bgfx::ShaderHandle sh = BGFX_INVALID_HANDLE;
+        if (const bgfx::Memory* mem = _load(path_)) sh = bgfx::createShader(mem);
+        if (!bgfx::isValid(sh)) {
+            std::cerr << "Failed to create shader: " << path_.string() << "\n";
+            return sh;
+        }
+
+        _shaders.emplace(key, sh);
+        return sh;
+    }
+
+
+    // シェーダはキャッシュが持っているので, プログラムを消してもシェーダは残す (destroyShaders = false)
+    auto ShaderCache::program (const std::filesystem::path& vs_path_, const std::filesystem::path& fs_path_)
+        -> bgfx::ProgramHandle
+    {
+        const bgfx::RendererType::Enum renderer = bgfx::getRendererType();
+        const std::pair<Key, Key>      key{ Key{ renderer, vs_path_.string() }, Key{ renderer, fs_path_.string() } };
+        if (auto it = _programs.find(key); it != _programs.end()) return it->second;
+
+        const bgfx::ShaderHandle vsh = shader(vs_path_);
+        const bgfx::ShaderHandle fsh = shader(fs_path_);
+        if (!bgfx::isValid(vsh) or !bgfx::isValid(fsh)) return BGFX_INVALID_HANDLE;
+
+        const bgfx::ProgramHandle ph = bgfx::createProgram(vsh, fsh, false);
+        if (!bgfx::isValid(ph)) {
+            std::cerr << "Failed to link shader program: " << vs_path_.string() << " + " << fs_path_.string() << "\n";
+            return ph;
+        }
+
+        _programs.emplace(key, ph);
+        return ph;
+    }
+
+
+    auto ShaderCache::clear (void)
+        -> void
+    {
+        for(auto& [key, ph] : _programs) bgfx::destroy(ph);
+        for(auto& [key, sh] : _shaders)  bgfx::destroy(sh);
+        _programs.clear();
+        _shaders.clear();
+    }
+}
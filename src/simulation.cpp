@@ -0,0 +1,118 @@
+#include <simulation.hpp>
+#include <panel_set.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace atpt{
+
+    //_ Constructor
+    Simulation::Simulation (PanelSet& panels_)
+        : _panels  ( panels_ )
+        , _mutex   ( )
+        , _waiting { 0 }
+        , _running { true }
+        , _thread  ( )
+    {
+        _thread = std::thread([this]{ _run(); });
+
+        return;
+    }
+
+
+    //_ Destructor
+    Simulation::~Simulation ()
+    {
+        stop();
+    }
+
+
+    //_ Inner Function
+    // rate() > 0 なら base からの経過時間 * rate() 世代までを進める. 遅れが maxBacklog() を超えた分は
+    // 進めずに捨てる (時計だけ進める). rate() == 0 なら休まずに進める.
+    // どちらでもフレームを作る (色付け・転送) のは描画スレッドが前のフレームを出し終えたときだけで,
+    // rate() > 0 では追いついた世代 (か, 追いつけないまま maxBacklog() 世代進んだところ) で出す.
+    // 出さない世代が続くときは maxBlock() 世代までを 1回の step() にまとめ, パネルにタイルごとに進めさせる
+    // (出すならその最後の世代). rate() == 0 で描画が前のフレームを出し終えていなければ maxBlock() 世代ずつ進める.
+    // パネルが世代の途中で返したら (Panel::yielded) ロックを離してから続きを進める
+    auto Simulation::_run (void)
+        -> void
+    {
+        using clock = std::chrono::steady_clock;
+
+        double            rate    = -1.0;
+        clock::time_point base;
+        uint64_t          done    = 0;
+        uint64_t          seen    = ~uint64_t{0};    // 最後にフレームを出したときの presented(). 最初の 1世代は必ず出す
+        uint64_t          held    = 0;               // 最後にフレームを出してから進めた世代数
+        uint64_t          shown   = 0;               // 今の世代を始めたときの presented()
+        uint64_t          count   = 1;               // 今の step() で進める世代数
+        bool              publish = false;
+        bool              partway = false;
+
+        while (_running.load(std::memory_order_acquire)) {
+            // pause() を待っている人がいれば先に譲る (std::mutex は公平ではない)
+            while (_waiting.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (not partway) {
+                const clock::time_point now = clock::now();
+                if (_panels.rate() != rate) {
+                    rate = _panels.rate();
+                    base = now;
+                    done = 0;
+                }
+
+                const uint64_t block = static_cast<uint64_t>(_panels.maxBlock());
+
+                bool last = true;
+                count     = 1;
+                if (rate > 0.0) {
+                    const uint64_t due     = static_cast<uint64_t>(std::floor(std::chrono::duration<double>(now - base).count() * rate));
+                    const uint64_t backlog = static_cast<uint64_t>(_panels.maxBacklog());
+                    if (due > done + backlog) done = due - backlog;
+                    if (due <= done) {
+                        lock.unlock();
+                        const auto next = base + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>((done + 1) / rate));
+                        // 止めるときと pause() が長く待たされないように, 1回の眠りは短く切る
+                        std::this_thread::sleep_until(std::min(next, now + std::chrono::milliseconds(10)));
+                        continue;
+                    }
+                    count = std::min({ due - done, backlog > held ? backlog - held : 1, block });
+                    last  = due == done + count or held + count >= backlog;
+                }
+
+                shown   = _panels.presented();
+                publish = last and shown != seen;
+                if (rate == 0.0 and not publish) count = block;
+            }
+
+            partway = _panels.step(publish, static_cast<int>(count)) == Panel::yielded;
+            if (partway) continue;
+
+            if (publish) { seen = shown; held = 0; }
+            else         { held += count; }
+            done += count;
+        }
+    }
+
+
+    //_ Variable Function
+    auto Simulation::pause (void)
+        -> std::unique_lock<std::mutex>
+    {
+        _waiting.fetch_add(1, std::memory_order_acq_rel);
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting.fetch_sub(1, std::memory_order_acq_rel);
+        return lock;
+    }
+
+
+    auto Simulation::stop (void)
+        -> void
+    {
+        _running.store(false, std::memory_order_release);
+        if (_thread.joinable()) _thread.join();
+    }
+}
@@ -0,0 +1,47 @@
+#include <step_task.hpp>
+#include <utility>
+
+namespace atpt{
+
+    //_ Constructor
+    StepTask::StepTask (StepTask&& other_) noexcept
+        : _h { std::exchange(other_._h, nullptr) }
+    {
+        return;
+    }
+
+
+    StepTask& StepTask::operator = (StepTask&& other_) noexcept
+    {
+        if (this != &other_) {
+            reset();
+            _h = std::exchange(other_._h, nullptr);
+        }
+        return *this;
+    }
+
+
+    //_ Destructor
+    StepTask::~StepTask ()
+    {
+        reset();
+    }
+
+
+    //_ Variable Function
+    auto StepTask::resume (void)
+        -> bool
+    {
+        if (not _h or _h.done()) return true;
+        _h.resume();
+        return _h.done();
+    }
+
+
+    auto StepTask::reset (void)
+        -> void
+    {
+        if (_h) _h.destroy();
+        _h = nullptr;
+    }
+}
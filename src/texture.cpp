@@ -0,0 +1,93 @@
+#include <texture.hpp>
+#include <algorithm>
+
+namespace atpt{
+
+    //+   Static Function    +//
+    // 足りなくなったら 1.5倍 (か要るだけ) に拡げ, align の倍数に切り上げる
+    auto Texture::_grow (int need_, int capacity_)
+        -> int
+    {
+        const int n = std::max(need_, capacity_ + capacity_ / 2);
+        return std::max(need_, std::min((n + align - 1) / align * align, max_size));
+    }
+
+
+    //+   Member Function    +//
+    //_ Constructor
+    Texture::Texture (const char* sampler_, bgfx::TextureFormat::Enum format_)
+        : _sampler         { sampler_ }
+        , _format          { format_ }
+        , _th              ( BGFX_INVALID_HANDLE )
+        , _uh              ( BGFX_INVALID_HANDLE )
+        , _sh              ( BGFX_INVALID_HANDLE )
+        , _width           { 0 }
+        , _height          { 0 }
+        , _capacity_width  { 0 }
+        , _capacity_height { 0 }
+    {
+        return;
+    }
+
+
+    //_ Variable Function
+    auto Texture::resize (int width_, int height_)
+        -> void
+    {
+        _width  = width_;
+        _height = height_;
+        if (_width <= _capacity_width and _height <= _capacity_height) return;
+
+        _capacity_width  = _width  > _capacity_width  ? _grow(_width,  _capacity_width)  : _capacity_width;
+        _capacity_height = _height > _capacity_height ? _grow(_height, _capacity_height) : _capacity_height;
+        if (bgfx::isValid(_th)) bgfx::destroy(_th);
+        _th = BGFX_INVALID_HANDLE;
+    }
+
+
+    // 点サンプリング. 使っている範囲の外はシェーダが読まないので, 確保しただけの所は未定義のままでよい
+    auto Texture::handle (void)
+        -> bgfx::TextureHandle
+    {
+        if (not bgfx::isValid(_th) and _width > 0 and _height > 0) {
+            if (_capacity_width  < _width)  _capacity_width  = _grow(_width,  _capacity_width);
+            if (_capacity_height < _height) _capacity_height = _grow(_height, _capacity_height);
+            _th = bgfx::createTexture2D(
+                static_cast<uint16_t>(_capacity_width), static_cast<uint16_t>(_capacity_height), false, 1, _format,
+                BGFX_SAMPLER_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP
+            );
+        }
+        if (not bgfx::isValid(_uh)) {
+            _uh = bgfx::createUniform(_sampler, bgfx::UniformType::Sampler);
+            _sh = bgfx::createUniform("u_texsize", bgfx::UniformType::Vec4);
+        }
+        return _th;
+    }
+
+
+    auto Texture::bind (uint8_t stage_)
+        -> void
+    {
+        const float size[4] = {
+            static_cast<float>(_capacity_width), static_cast<float>(_capacity_height),
+            static_cast<float>(_width),          static_cast<float>(_height)
+        };
+        bgfx::setTexture(stage_, _uh, handle());
+        bgfx::setUniform(_sh, size);
+    }
+
+
+    // 使う大きさは残すので, 次の handle() でその大きさから作り直せる
+    auto Texture::destroy (void)
+        -> void
+    {
+        if (bgfx::isValid(_th)) bgfx::destroy(_th);
+        if (bgfx::isValid(_sh)) bgfx::destroy(_sh);
+        if (bgfx::isValid(_uh)) bgfx::destroy(_uh);
+        _th              = BGFX_INVALID_HANDLE;
+        _sh              = BGFX_INVALID_HANDLE;
+        _uh              = BGFX_INVALID_HANDLE;
+        _capacity_width  = 0;
+        _capacity_height = 0;
+    }
+}
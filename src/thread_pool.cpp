@@ -0,0 +1,104 @@
+#include <thread_pool.hpp>
+
+namespace atpt{
+
+    //+   Static Variable    +//
+    int ThreadPool::_worker_count = ThreadPool::auto_workers;
+
+
+    //+   Member Function    +//
+    //_ Constructor
+    ThreadPool::ThreadPool (size_t workers_)
+        : _workers ( )
+        , _tasks   ( )
+        , _mutex   ( )
+        , _cv      ( )
+        , _stop    { false }
+    {
+        for(size_t i = 0; i < workers_; ++i){
+            _workers.emplace_back([this]{ _work(); });
+        }
+
+        return;
+    }
+
+
+    //_ Destructor
+    ThreadPool::~ThreadPool ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_all();
+
+        for(std::thread& t : _workers) t.join();
+    }
+
+
+    //_ Static Function
+    // shared() を最初に呼ぶ前に設定する. 0 ならワーカーを作らず, parallelFor は呼び出し側だけで順に進める
+    // (並列版と結果が一致するかを見る基準になる). 負の値は auto_workers と同じ
+    auto ThreadPool::setWorkerCount (int n_)
+        -> void
+    {
+        _worker_count = n_;
+    }
+
+
+    auto ThreadPool::shared (void)
+        -> ThreadPool&
+    {
+        static ThreadPool pool(
+            _worker_count >= 0 ? static_cast<size_t>(_worker_count)
+                               : std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1
+        );
+        return pool;
+    }
+
+
+    //_ Inner Function
+    auto ThreadPool::_push (std::function<void()> task_)
+        -> void
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.push_back(std::move(task_));
+        }
+        _cv.notify_one();
+    }
+
+
+    auto ThreadPool::_runOne (void)
+        -> bool
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_tasks.empty()) return false;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+        return true;
+    }
+
+
+    auto ThreadPool::_work (void)
+        -> void
+    {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this]{ return _stop or not _tasks.empty(); });
+                if (_stop and _tasks.empty()) return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+}
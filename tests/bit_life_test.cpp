@@ -0,0 +1,282 @@
+#include "check.hpp"
+#include <bit_life.hpp>
+#include <active_tiles.hpp>
+#include <bit_grid.hpp>
+#include <cpu_features.hpp>
+#include <life_like_rule.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace atpt;
+
+namespace{
+
+    // 比べる相手. セルごとに周期境界で 8近傍を数えるだけの素朴な実装
+    struct Naive{
+        int                  width, height;
+        std::vector<uint8_t> cells;
+
+        auto at (int x_, int y_) const -> int { return cells[static_cast<size_t>((y_ + height) % height) * width + (x_ + width) % width]; }
+
+        template <typename Rule>
+        auto step (void)
+            -> void
+        {
+            std::vector<uint8_t> next(cells.size());
+            for(int y = 0; y < height; ++y){
+                const uint8_t* up   = cells.data() + static_cast<size_t>((y + height - 1) % height) * width;
+                const uint8_t* mid  = cells.data() + static_cast<size_t>(y) * width;
+                const uint8_t* down = cells.data() + static_cast<size_t>((y + 1) % height) * width;
+                for(int x = 0; x < width; ++x){
+                    const int l   = (x + width - 1) % width;
+                    const int r   = (x + 1) % width;
+                    const int sum = up[l] + up[x] + up[r] + mid[l] + mid[r] + down[l] + down[x] + down[r];
+                    next[static_cast<size_t>(y) * width + x] = Rule::next(mid[x], sum);
+                }
+            }
+            cells.swap(next);
+        }
+    };
+
+
+    struct Case{
+        int    width, height;
+        double density;
+    };
+
+    // 1x1 や幅・高さが 64 で割り切れないもの, 端のタイルが 1セルしかないもの (65, 130) を混ぜる
+    constexpr Case cases[] = {
+        {   1,   1, 0.5  },
+        {   5,   3, 0.5  },
+        {  64,  64, 0.3  },
+        {  65, 130, 0.3  },
+        { 129,  70, 0.01 },
+        { 197, 131, 0.05 },
+    };
+
+
+    auto randomize (PeriodicBoundaryBitGrid& grid_, Naive& ref_, double density_, uint32_t seed_)
+        -> void
+    {
+        std::mt19937                rng(seed_);
+        std::bernoulli_distribution alive(density_);
+        ref_ = { grid_.width(), grid_.height(), std::vector<uint8_t>(static_cast<size_t>(grid_.width()) * grid_.height()) };
+        for(int y = 0; y < grid_.height(); ++y){
+            for(int x = 0; x < grid_.width(); ++x){
+                const bool v = alive(rng);
+                grid_.set(x, y, v);
+                ref_.cells[static_cast<size_t>(y) * grid_.width() + x] = v;
+            }
+        }
+        grid_.fillHalo();
+    }
+
+
+    auto same (const PeriodicBoundaryBitGrid& grid_, const Naive& ref_)
+        -> bool
+    {
+        for(int y = 0; y < grid_.height(); ++y){
+            for(int x = 0; x < grid_.width(); ++x){
+                if (grid_(x, y) != static_cast<bool>(ref_.at(x, y))) return false;
+            }
+        }
+        return true;
+    }
+
+
+    // 世代を 1つずつ全面で進める
+    template <typename Rule>
+    auto testStep (const Case& c_, uint32_t seed_)
+        -> void
+    {
+        PeriodicBoundaryBitGrid src(c_.width, c_.height), dst(c_.width, c_.height);
+        Naive                   ref;
+        randomize(src, ref, c_.density, seed_);
+
+        for(int g = 0; g < 40; ++g){
+            ATPT_CHECK(bitLifeStep<Rule>(src, dst) == 0);
+            std::swap(src, dst);
+            ref.template step<Rule>();
+            if (not ATPT_CHECK(same(src, ref))) {
+                std::fprintf(stderr, "  bitLifeStep %s %dx%d gen %d\n", simdLevelName(bitLifeSimdLevel()), c_.width, c_.height, g + 1);
+                return;
+            }
+        }
+    }
+
+
+    // 変化したタイルだけを進める. タイル行を 2つに分けて呼び, 担当範囲の境目も通す
+    template <typename Rule>
+    auto testTiles (const Case& c_, uint32_t seed_)
+        -> void
+    {
+        PeriodicBoundaryBitGrid src(c_.width, c_.height), dst(c_.width, c_.height);
+        ActiveTiles             in(c_.width, c_.height),  out(c_.width, c_.height);
+        Naive                   ref;
+        randomize(src, ref, c_.density, seed_);
+
+        const int split = in.tilesY() / 2;
+        for(int g = 0; g < 60; ++g){
+            bitLifeStepTiles<Rule>(src, dst, in, out, 0, split);
+            bitLifeStepTiles<Rule>(src, dst, in, out, split, in.tilesY());
+            dst.fillHalo();
+            std::swap(src, dst);
+            std::swap(in, out);
+            ref.template step<Rule>();
+            if (not ATPT_CHECK(same(src, ref))) {
+                std::fprintf(stderr, "  bitLifeStepTiles %s %dx%d gen %d\n", simdLevelName(bitLifeSimdLevel()), c_.width, c_.height, g + 1);
+                return;
+            }
+        }
+    }
+
+
+    // LifeLikeCA と同じく, k == 1 なら bitLifeStepTiles, それ以外は bitLifeStepBlocked で k 世代まとめて進める
+    template <typename Rule>
+    auto stepTiles (PeriodicBoundaryBitGrid& src_, PeriodicBoundaryBitGrid& dst_, ActiveTiles& in_, ActiveTiles& out_, int k_)
+        -> void
+    {
+        if (k_ == 1) bitLifeStepTiles<Rule>(src_, dst_, in_, out_, 0, in_.tilesY());
+        else         bitLifeStepBlocked<Rule>(src_, dst_, in_, out_, 0, in_.tilesY(), k_);
+        dst_.fillHalo();
+        std::swap(src_, dst_);
+        std::swap(in_, out_);
+    }
+
+
+    template <typename Rule>
+    auto testBlocked (const Case& c_, uint32_t seed_)
+        -> void
+    {
+        PeriodicBoundaryBitGrid src(c_.width, c_.height), dst(c_.width, c_.height);
+        ActiveTiles             in(c_.width, c_.height),  out(c_.width, c_.height);
+        Naive                   ref;
+        randomize(src, ref, c_.density, seed_);
+
+        std::mt19937                       rng(seed_);
+        std::uniform_int_distribution<int> gens(1, ActiveTiles::tile_size);
+        int                                g = 0;
+        for(int i = 0; i < 5; ++i){
+            const int k = (i == 0) ? ActiveTiles::tile_size : gens(rng);
+            stepTiles<Rule>(src, dst, in, out, k);
+            for(int t = 0; t < k; ++t) ref.template step<Rule>();
+            g += k;
+            if (not ATPT_CHECK(same(src, ref))) {
+                std::fprintf(stderr, "  bitLifeStepBlocked %s %dx%d k %d gen %d\n", simdLevelName(bitLifeSimdLevel()), c_.width, c_.height, k, g);
+                return;
+            }
+        }
+    }
+
+
+    // 途中のタイル行で止めた bitLifeStepBlocked を捨てる. 入れ替えずに入力の印を全部立て直せば (LifeLikeCA::_abandon),
+    // 同じ src から 1世代ずつのステップに戻っても, dst に残った何世代か先の値に引きずられない
+    template <typename Rule>
+    auto testAbandoned (const Case& c_, uint32_t seed_)
+        -> void
+    {
+        PeriodicBoundaryBitGrid src(c_.width, c_.height), dst(c_.width, c_.height);
+        ActiveTiles             in(c_.width, c_.height),  out(c_.width, c_.height);
+        Naive                   ref;
+        randomize(src, ref, c_.density, seed_);
+
+        std::mt19937                       rng(seed_);
+        std::uniform_int_distribution<int> gens(2, ActiveTiles::tile_size);
+        int                                g = 0;
+        for(int i = 0; i < 4; ++i){
+            const int k = gens(rng);
+            stepTiles<Rule>(src, dst, in, out, k);
+            for(int t = 0; t < k; ++t) ref.template step<Rule>();
+            g += k;
+
+            const int stop = std::uniform_int_distribution<int>(0, in.tilesY())(rng);
+            bitLifeStepBlocked<Rule>(src, dst, in, out, 0, stop, gens(rng));
+            in.markAll();
+
+            for(int t = 0; t < 3; ++t){
+                stepTiles<Rule>(src, dst, in, out, 1);
+                ref.template step<Rule>();
+                ++g;
+                if (not ATPT_CHECK(same(src, ref))) {
+                    std::fprintf(stderr, "  abandoned bitLifeStepBlocked %s %dx%d gen %d\n", simdLevelName(bitLifeSimdLevel()), c_.width, c_.height, g);
+                    return;
+                }
+            }
+        }
+    }
+
+
+    // 上の取り違えが実際に起きる配置. 幅 449 では右端のタイルが 1セルしかないので, k > 1 の bitLifeStepBlocked は
+    // 2タイル先まで計算する. タイル 6 の右端を右下へ進むグライダーは, k 世代のうちに端のタイルを越えてタイル 0 に入るが,
+    // タイル 0 は 1世代のステップでは計算されない. 印を立て直さないと dst に残った k 世代先のグライダーが出てくる
+    template <typename Rule>
+    auto testAbandonedNarrow (void)
+        -> void
+    {
+        constexpr int width  = 7 * ActiveTiles::tile_size + 1;
+        constexpr int height = ActiveTiles::tile_size + 1;
+
+        PeriodicBoundaryBitGrid src(width, height), dst(width, height);
+        ActiveTiles             in(width, height),  out(width, height);
+        Naive                   ref;
+        randomize(src, ref, 0.0, 0);
+
+        constexpr int glider[5][2] = { { 1, 0 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
+        for(const auto& [x, y] : glider){
+            src.set(width - 12 + x, 30 + y, true);
+            ref.cells[static_cast<size_t>(30 + y) * width + width - 12 + x] = 1;
+        }
+        src.fillHalo();
+
+        // 1世代進めて, 変化の印をグライダーのいるタイルだけにする
+        stepTiles<Rule>(src, dst, in, out, 1);
+        ref.template step<Rule>();
+
+        bitLifeStepBlocked<Rule>(src, dst, in, out, 0, in.tilesY(), 48);
+        in.markAll();
+
+        for(int t = 0; t < 3; ++t){
+            stepTiles<Rule>(src, dst, in, out, 1);
+            ref.template step<Rule>();
+            if (not ATPT_CHECK(same(src, ref))) {
+                std::fprintf(stderr, "  abandoned bitLifeStepBlocked across a narrow tile %s gen %d\n", simdLevelName(bitLifeSimdLevel()), t + 2);
+                return;
+            }
+        }
+    }
+
+
+    template <typename Rule>
+    auto testRule (void)
+        -> void
+    {
+        uint32_t seed = 1;
+        for(const Case& c : cases){
+            testStep<Rule>(c, seed++);
+            testTiles<Rule>(c, seed++);
+            testBlocked<Rule>(c, seed++);
+            testAbandoned<Rule>(c, seed++);
+        }
+        testAbandonedNarrow<Rule>();
+    }
+}
+
+
+// この CPU で使える命令セットをすべて (Scalar まで下げて) 試す
+auto main (void)
+    -> int
+{
+    const SimdLevel top = detectSimdLevel();
+    for(SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }){
+        if (level > top) break;
+        setBitLifeSimdLevel(level);
+        testRule<Conway>();
+        testRule<HighLife>();
+    }
+    setBitLifeSimdLevel(top);
+
+    return test::report("bit_life_test");
+}
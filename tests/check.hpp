@@ -0,0 +1,32 @@
+#ifndef ATPT_TESTS_CHECK_HPP
+#define ATPT_TESTS_CHECK_HPP
+
+#include <cstdio>
+
+namespace atpt::test{
+
+    inline int failures = 0;
+
+    // 失敗しても止めずに数えるだけ. 戻り値で呼び出し側が条件を書き足せる
+    inline auto check (bool ok_, const char* expr_, const char* file_, int line_)
+        -> bool
+    {
+        if (not ok_) {
+            ++failures;
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file_, line_, expr_);
+        }
+        return ok_;
+    }
+
+    // main の戻り値. 1つでも失敗していれば ctest に失敗を返す
+    inline auto report (const char* name_)
+        -> int
+    {
+        std::fprintf(failures ? stderr : stdout, "%s: %d failure(s)\n", name_, failures);
+        return failures ? 1 : 0;
+    }
+}
+
+#define ATPT_CHECK(expr_) ::atpt::test::check(static_cast<bool>(expr_), #expr_, __FILE__, __LINE__)
+
+#endif
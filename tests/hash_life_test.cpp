@@ -0,0 +1,109 @@
+#include "check.hpp"
+#include <hash_life.hpp>
+#include <bit_grid.hpp>
+#include <bit_life.hpp>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace atpt;
+
+namespace{
+
+    // 比べる相手は bitLifeStep で進めるトーラス. 見る範囲の世代数ではパターンが端まで届かない大きさにする
+    constexpr int torus  = 512;
+    constexpr int soup   = 40;
+    constexpr int window = 400;
+
+    auto randomSoup (uint32_t seed_)
+        -> PeriodicBoundaryBitGrid
+    {
+        PeriodicBoundaryBitGrid grid(soup, soup);
+        std::mt19937            rng(seed_);
+        for(int y = 0; y < soup; ++y) for(int x = 0; x < soup; ++x) grid.set(x, y, rng() & 1);
+        grid.fillHalo();
+        return grid;
+    }
+
+
+    auto populationOf (const PeriodicBoundaryBitGrid& grid_)
+        -> uint64_t
+    {
+        uint64_t n = 0;
+        for(int y = 0; y < grid_.height(); ++y) for(int x = 0; x < grid_.width(); ++x) n += grid_(x, y);
+        return n;
+    }
+
+
+    // 原点を中心にした 40x40 の種を, ノード数の上限 max_nodes_ で 2^k 世代ずつ進める
+    auto testAdvance (size_t max_nodes_, uint32_t seed_)
+        -> void
+    {
+        const PeriodicBoundaryBitGrid seed = randomSoup(seed_);
+
+        PeriodicBoundaryBitGrid ref(torus, torus), tmp(torus, torus);
+        for(int y = 0; y < soup; ++y) for(int x = 0; x < soup; ++x) ref.set(torus / 2 - soup / 2 + x, torus / 2 - soup / 2 + y, seed(x, y));
+        ref.fillHalo();
+
+        HashLife life(max_nodes_);
+        life.load(seed, -soup / 2, -soup / 2);
+
+        uint64_t              generation = 0;
+        std::vector<uint32_t> pixels(static_cast<size_t>(window) * window);
+        for(int k : { 0, 0, 1, 2, 3, 2, 4, 5, 1, 0, 6, 3, 6 }){
+            ATPT_CHECK(life.advance(k) == 0);
+            for(uint64_t i = 0; i < (uint64_t{1} << k); ++i){
+                bitLifeStep(ref, tmp);
+                std::swap(ref, tmp);
+            }
+            generation += uint64_t{1} << k;
+
+            ATPT_CHECK(life.generation() == generation);
+            ATPT_CHECK(life.population() == populationOf(ref));
+
+            life.rasterize(-window / 2, -window / 2, window, window, 0, pixels.data(), 1, 0);
+            int diff = 0;
+            for(int y = 0; y < window; ++y){
+                for(int x = 0; x < window; ++x){
+                    diff += (pixels[static_cast<size_t>(y) * window + x] == 1) != ref(torus / 2 - window / 2 + x, torus / 2 - window / 2 + y);
+                }
+            }
+            if (not ATPT_CHECK(diff == 0)) {
+                std::fprintf(stderr, "  max_nodes %zu generation %llu: %d cells differ\n", max_nodes_, static_cast<unsigned long long>(generation), diff);
+                return;
+            }
+        }
+
+        // collect() は生きているノードを残したまま減らす
+        const size_t before = life.nodeCount();
+        life.collect();
+        ATPT_CHECK(life.nodeCount() <= before);
+        ATPT_CHECK(life.population() == populationOf(ref));
+    }
+
+
+    // advance の途中でも回収するので, 計算中のノードが上限に収まる間はノード数が上限の 2倍を越えない
+    auto testLimit (void)
+        -> void
+    {
+        HashLife life(1000);
+        life.load(randomSoup(9), 0, 0);
+        for(int i = 0; i < 8; ++i){
+            ATPT_CHECK(life.advance(5) == 0);
+            if (not ATPT_CHECK(life.nodeCount() <= 2 * life.maxNodes())) std::fprintf(stderr, "  %zu nodes after advance %d\n", life.nodeCount(), i);
+        }
+    }
+}
+
+
+auto main (void)
+    -> int
+{
+    testAdvance(size_t{1} << 21, 5);
+    testAdvance(2000, 5);
+    testAdvance(300, 6);
+    testLimit();
+
+    return test::report("hash_life_test");
+}
@@ -0,0 +1,70 @@
+#include "check.hpp"
+#include <lfsr.hpp>
+#include <cstdint>
+#include <random>
+
+using namespace atpt;
+
+namespace{
+
+    // jump(n) は step() を n 回呼んだのと同じ状態になる
+    auto testJump (uint32_t state_)
+        -> void
+    {
+        std::mt19937_64 rng(state_);
+        for(uint64_t n : { uint64_t{0}, uint64_t{1}, uint64_t{2}, uint64_t{31}, uint64_t{32}, uint64_t{33}, uint64_t{1000}, rng() % 5000, rng() % 5000 }){
+            Lfsr32 a(state_), b(state_);
+            a.jump(n);
+            for(uint64_t i = 0; i < n; ++i) b.step();
+            if (not ATPT_CHECK(a.state() == b.state())) std::fprintf(stderr, "  state %08x jump %llu\n", state_, static_cast<unsigned long long>(n));
+        }
+
+        // 大きなステップ数は分けて飛んでも同じ
+        const uint64_t big = (uint64_t{1} << 40) + (rng() & 0xFFFFFF);
+        const uint64_t cut = rng() % big;
+        Lfsr32 a(state_), b(state_);
+        a.jump(big);
+        b.jump(cut);
+        b.jump(big - cut);
+        ATPT_CHECK(a.state() == b.state());
+    }
+
+
+    // next32 / next64 は step() の出力を下位ビットから詰めたもの
+    auto testNext (uint32_t state_)
+        -> void
+    {
+        Lfsr32 a(state_), b(state_), c(state_);
+        for(int i = 0; i < 5; ++i){
+            uint32_t bits = 0;
+            for(int j = 0; j < 32; ++j) bits |= b.step() << j;
+            ATPT_CHECK(a.next32() == bits);
+            ATPT_CHECK(a.state() == b.state());
+        }
+
+        Lfsr32 d(state_);
+        for(int i = 0; i < 5; ++i){
+            const uint64_t lo = d.next32();
+            const uint64_t hi = d.next32();
+            ATPT_CHECK(c.next64() == (lo | (hi << 32)));
+        }
+    }
+}
+
+
+auto main (void)
+    -> int
+{
+    // 0 は不動点
+    Lfsr32 zero(0);
+    zero.jump(12345);
+    ATPT_CHECK(zero.state() == 0);
+
+    std::mt19937 rng(7);
+    for(uint32_t state : { uint32_t{1}, uint32_t{0x80000000u}, uint32_t{0xFFFFFFFFu}, static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()) }){
+        testJump(state);
+        testNext(state);
+    }
+
+    return test::report("lfsr_test");
+}
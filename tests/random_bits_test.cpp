@@ -0,0 +1,142 @@
+#include "check.hpp"
+#include <random_bits.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace atpt;
+
+namespace{
+
+    // Random123 の既知解 (kat_vectors, philox4x32 10 ラウンド). カウンタ・鍵は下位の語から
+    constexpr std::array<uint32_t, 4> kat_zero = { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u };
+    static_assert(philox4x32({ 0, 0, 0, 0 }, 0) == kat_zero);
+
+    auto testPhilox (void)
+        -> void
+    {
+        ATPT_CHECK((philox4x32({ 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu }, 0xffffffffffffffffull)
+                    == std::array<uint32_t, 4>{ 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu }));
+        ATPT_CHECK((philox4x32({ 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u }, 0x299f31d0a4093822ull)
+                    == std::array<uint32_t, 4>{ 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u }));
+
+        // counterRandom(0, 0, 0/1) は既知解の前半と後半
+        ATPT_CHECK(counterRandom(0, 0, 0) == 0xe169c58d6627e8d5ull);
+        ATPT_CHECK(counterRandom(0, 0, 1) == 0x9b00dbd8bc57ac4cull);
+    }
+
+
+    // fillCounterRandom は counterRandom を並べたもの. 奇数の開始位置と 4ブロックで割り切れない長さで SIMD の端も通す
+    auto testFillCounter (void)
+        -> void
+    {
+        uint64_t kat[2];
+        fillCounterRandom(0, 0, 0, kat, 2);
+        ATPT_CHECK(kat[0] == 0xe169c58d6627e8d5ull);
+        ATPT_CHECK(kat[1] == 0x9b00dbd8bc57ac4cull);
+
+        std::mt19937_64 rng(3);
+        for(size_t n : { size_t{0}, size_t{1}, size_t{2}, size_t{7}, size_t{8}, size_t{9}, size_t{31}, size_t{100} }){
+            for(uint64_t index : { uint64_t{0}, uint64_t{1}, uint64_t{5}, (uint64_t{1} << 32) - 3, rng() }){
+                const uint64_t seed = rng(), generation = rng();
+                std::vector<uint64_t> out(n + 1, 0x5555555555555555ull);
+                fillCounterRandom(seed, generation, index, out.data(), n);
+
+                bool ok = true;
+                for(size_t j = 0; j < n; ++j) ok = ok and out[j] == counterRandom(seed, generation, index + j);
+                if (not ATPT_CHECK(ok)) std::fprintf(stderr, "  fillCounterRandom index %llu n %zu\n", static_cast<unsigned long long>(index), n);
+                ATPT_CHECK(out[n] == 0x5555555555555555ull);
+            }
+        }
+    }
+
+
+    // xoshiro256++ を 1本ずつ素直に書いたもの. seed は splitmix64, レーン l は jump() を l 回
+    struct Xoshiro256{
+        uint64_t s[4];
+
+        static auto rotl (uint64_t x_, int k_) -> uint64_t { return (x_ << k_) | (x_ >> (64 - k_)); }
+
+        auto next (void)
+            -> uint64_t
+        {
+            const uint64_t r = rotl(s[0] + s[3], 23) + s[0];
+            const uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3]  = rotl(s[3], 45);
+            return r;
+        }
+
+        auto jump (void)
+            -> void
+        {
+            static constexpr uint64_t poly[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+            uint64_t j[4] = { 0, 0, 0, 0 };
+            for(uint64_t m : poly){
+                for(int b = 0; b < 64; ++b){
+                    if ((m >> b) & 1u) for(int k = 0; k < 4; ++k) j[k] ^= s[k];
+                    next();
+                }
+            }
+            for(int k = 0; k < 4; ++k) s[k] = j[k];
+        }
+    };
+
+    auto splitmix64 (uint64_t& x_)
+        -> uint64_t
+    {
+        uint64_t z = (x_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+
+    // out[4j + l] はレーン l の j番目. fill を呼ぶたびにレーン 0 から使う
+    auto testXoshiro (uint64_t seed_)
+        -> void
+    {
+        Xoshiro256 lanes[4];
+        uint64_t   x = seed_;
+        for(uint64_t& w : lanes[0].s) w = splitmix64(x);
+        for(int l = 1; l < 4; ++l){
+            lanes[l] = lanes[l - 1];
+            lanes[l].jump();
+        }
+
+        Xoshiro256x4 engine(seed_);
+        for(size_t n : { size_t{1}, size_t{4}, size_t{7}, size_t{13}, size_t{64}, size_t{3} }){
+            std::vector<uint64_t> out(n);
+            fillRandom(engine, out.data(), n);
+
+            bool ok = true;
+            for(size_t j = 0; j < n; ++j) ok = ok and out[j] == lanes[j & 3].next();
+            if (not ATPT_CHECK(ok)) std::fprintf(stderr, "  Xoshiro256x4 seed %llu n %zu\n", static_cast<unsigned long long>(seed_), n);
+        }
+
+        // seed() で作り直すと同じ列に戻る
+        uint64_t a[9], b[9];
+        engine.seed(seed_);
+        engine.fill(a, 9);
+        Xoshiro256x4(seed_).fill(b, 9);
+        ATPT_CHECK(std::equal(std::begin(a), std::end(a), std::begin(b)));
+    }
+}
+
+
+auto main (void)
+    -> int
+{
+    testPhilox();
+    testFillCounter();
+    for(uint64_t seed : { uint64_t{0}, uint64_t{1}, uint64_t{0xDEADBEEFCAFEull} }) testXoshiro(seed);
+
+    return test::report("random_bits_test");
+}
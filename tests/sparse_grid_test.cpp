@@ -0,0 +1,140 @@
+#include "check.hpp"
+#include <sparse_grid.hpp>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+using namespace atpt;
+
+namespace{
+
+    // 8x8 セルのチャンク. 小さくしてチャンクの境目と負の座標を多く通す
+    using Grid = SparseGrid<int, 3>;
+    using Ref  = std::map<std::pair<int, int>, int>;
+
+    constexpr int lo = -40;
+    constexpr int hi =  40;
+
+    auto at (const Ref& ref_, int x_, int y_)
+        -> int
+    {
+        const auto it = ref_.find({ x_, y_ });
+        return it == ref_.end() ? -1 : it->second;
+    }
+
+
+    auto same (const Grid& grid_, const Ref& ref_)
+        -> bool
+    {
+        for(int y = lo - 8; y < hi + 8; ++y){
+            for(int x = lo - 8; x < hi + 8; ++x){
+                if (grid_(x, y) != at(ref_, x, y)) return false;
+            }
+        }
+        return true;
+    }
+
+
+    // 既定値以外のセルが 1つでもあるチャンクの集合
+    auto occupied (const Ref& ref_)
+        -> std::set<std::pair<int, int>>
+    {
+        std::set<std::pair<int, int>> out;
+        for(const auto& [p, v] : ref_) if (v != -1) out.insert({ p.first >> 3, p.second >> 3 });
+        return out;
+    }
+
+
+    auto testAccess (void)
+        -> void
+    {
+        Grid                               grid(-1, 4);    // 表を何度か広げさせる
+        Ref                                ref;
+        std::mt19937                       rng(11);
+        std::uniform_int_distribution<int> coord(lo, hi - 1), value(-1, 3);
+
+        ATPT_CHECK(grid.defaultValue() == -1);
+        ATPT_CHECK(std::as_const(grid)(-1000, 1000) == -1);
+        ATPT_CHECK(grid.chunkCount() == 0);
+
+        // 既定値を書くだけならチャンクを作らない
+        grid.set(-5, -5, -1);
+        ATPT_CHECK(grid.chunkCount() == 0);
+
+        for(int i = 0; i < 4000; ++i){
+            const int x = coord(rng), y = coord(rng), v = value(rng);
+            if (i & 1) grid.set(x, y, v);
+            else       grid(x, y) = v;
+            ref[{ x, y }] = v;
+        }
+        ATPT_CHECK(same(grid, ref));
+
+        // neumann / moore は周りのセル (確保されていなければ既定値) を指す
+        for(int i = 0; i < 2000; ++i){
+            const int x = coord(rng) - 4, y = coord(rng) - 4;
+            const auto n = grid.neumann(x, y);
+            const int  nx[5] = { x, x - 1, x, x + 1, x };
+            const int  ny[5] = { y - 1, y, y, y, y + 1 };
+            for(int k = 0; k < 5; ++k) ATPT_CHECK(*n[k] == at(ref, nx[k], ny[k]));
+
+            const auto m = grid.moore(x, y);
+            for(int dy = -1, k = 0; dy <= 1; ++dy){
+                for(int dx = -1; dx <= 1; ++dx, ++k) ATPT_CHECK(*m[k] == at(ref, x + dx, y + dy));
+            }
+        }
+
+        // forEachChunk は確保済みのチャンクをちょうど 1回ずつ渡す
+        size_t chunks = 0;
+        bool   ok     = true;
+        grid.forEachChunk([&](int cx_, int cy_, const int* cells_){
+            ++chunks;
+            ok = ok and grid.chunk(cx_, cy_) == cells_;
+            for(int y = 0; y < Grid::chunk_size; ++y){
+                for(int x = 0; x < Grid::chunk_size; ++x){
+                    ok = ok and cells_[y * Grid::chunk_size + x] == at(ref, cx_ * 8 + x, cy_ * 8 + y);
+                }
+            }
+        });
+        ATPT_CHECK(ok);
+        ATPT_CHECK(chunks == grid.chunkCount());
+        ATPT_CHECK(grid.chunk(1000, 1000) == nullptr);
+
+        // x, y がともに負のセルを既定値に戻すと, そのチャンクだけが回収される
+        for(auto& [p, v] : ref){
+            if (p.first < 0 and p.second < 0) {
+                v = -1;
+                grid.set(p.first, p.second, -1);
+            }
+        }
+        const size_t before = grid.chunkCount();
+        const size_t freed  = grid.collect();
+        ATPT_CHECK(freed > 0);
+        ATPT_CHECK(grid.chunkCount() == before - freed);
+        ATPT_CHECK(grid.chunkCount() == occupied(ref).size());
+        ATPT_CHECK(grid.collect() == 0);
+        ATPT_CHECK(same(grid, ref));
+
+        // 回収した後も書き込めて, 空いたチャンクが使い回される
+        for(int i = 0; i < 1000; ++i){
+            const int x = coord(rng), y = coord(rng), v = value(rng);
+            grid(x, y) = v;
+            ref[{ x, y }] = v;
+        }
+        ATPT_CHECK(same(grid, ref));
+
+        grid.clear();
+        ATPT_CHECK(grid.chunkCount() == 0);
+        ATPT_CHECK(same(grid, {}));
+    }
+}
+
+
+auto main (void)
+    -> int
+{
+    testAccess();
+
+    return test::report("sparse_grid_test");
+}